@@ -0,0 +1,169 @@
+#include "aircraft_profile.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define AIRCRAFT_PROFILE_MAX_BYTES  65536   // Anything bigger isn't a profile
+
+// Where each numeric key lands
+struct ProfileKey {
+    const char* name;
+    float AoaThresholds::*threshold;    // one of these is set, neither for filter_window
+    float ToneSettings::*tone;
+};
+
+static const ProfileKey PROFILE_KEYS[] = {
+    {"below_ldmax", &AoaThresholds::belowLDMax, nullptr},
+    {"below_onspeed", &AoaThresholds::belowOnSpeed, nullptr},
+    {"onspeed_max", &AoaThresholds::onSpeedMax, nullptr},
+    {"above_onspeed_max", &AoaThresholds::aboveOnSpeedMax, nullptr},
+    {"ias_tone_enable", &AoaThresholds::iasToneEnable, nullptr},
+    {"filter_window", nullptr, nullptr},
+    {"tone_normal_hz", nullptr, &ToneSettings::normalFrequency},
+    {"tone_high_hz", nullptr, &ToneSettings::highFrequency},
+    {"pulse_rate_min", nullptr, &ToneSettings::belowOnSpeedPulseMin},
+    {"pulse_rate_max", nullptr, &ToneSettings::belowOnSpeedPulseMax},
+    {"above_onspeed_pulse_min", nullptr, &ToneSettings::aboveOnSpeedPulseMin},
+    {"above_onspeed_pulse_max", nullptr, &ToneSettings::aboveOnSpeedPulseMax},
+    {"pulse_rate_stall", nullptr, &ToneSettings::stallPulseRate},
+    {"volume", nullptr, &ToneSettings::volume},
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+AircraftProfile defaultAircraftProfile() {
+    AircraftProfile profile;
+    profile.aircraft[0] = '\0';
+    profile.thresholds = defaultAoaThresholds();
+    profile.filterWindow = AOA_HISTORY_SIZE;
+    profile.tone = defaultToneSettings();
+    return profile;
+}
+
+bool isValidAircraftProfile(const AircraftProfile& profile) {
+    return isValidAoaThresholds(profile.thresholds) && profile.filterWindow >= 1 &&
+           profile.filterWindow <= AOA_HISTORY_MAX && isValidToneSettings(profile.tone);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Trim in place and return the start
+static char* trim(char* text) {
+    while (isspace(static_cast<unsigned char>(*text))) {
+        text++;
+    }
+    char* end = text + strlen(text);
+    while (end > text && isspace(static_cast<unsigned char>(end[-1]))) {
+        *--end = '\0';
+    }
+    return text;
+}
+
+bool parseAircraftProfile(const char* text, AircraftProfile& profile, char* error, int errorSize) {
+    AircraftProfile parsed = defaultAircraftProfile();
+    std::string copy(text);
+    int lineNumber = 0;
+
+    for (char* line = &copy[0]; line && *line; ) {
+        char* next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        lineNumber++;
+
+        char* hash = strchr(line, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+        char* equals = strchr(line, '=');
+        if (!equals) {
+            if (*trim(line)) {
+                snprintf(error, errorSize, "line %d: expected key = value", lineNumber);
+                return false;
+            }
+            line = next;
+            continue;
+        }
+        *equals = '\0';
+        const char* key = trim(line);
+        const char* value = trim(equals + 1);
+
+        if (!strcmp(key, "aircraft")) {
+            snprintf(parsed.aircraft, sizeof(parsed.aircraft), "%s", value);
+        } else {
+            for (const ProfileKey& known : PROFILE_KEYS) {
+                if (strcmp(key, known.name)) {
+                    continue;
+                }
+                char* end;
+                double number = strtod(value, &end);
+                if (end == value || *end) {
+                    snprintf(error, errorSize, "line %d: %s is not a number", lineNumber, key);
+                    return false;
+                }
+                if (known.threshold) {
+                    parsed.thresholds.*known.threshold = static_cast<float>(number);
+                } else if (known.tone) {
+                    parsed.tone.*known.tone = static_cast<float>(number);
+                } else {
+                    parsed.filterWindow = static_cast<int>(number);
+                }
+            }
+        }
+        line = next;
+    }
+
+    if (!isValidToneSettings(parsed.tone)) {
+        snprintf(error, errorSize, "tones must be %.0f to %.0f Hz, pulse rates increase up to %.0f and volume be 0 to 1",
+                 TONE_FREQUENCY_MIN, TONE_FREQUENCY_MAX, TONE_PULSE_RATE_MAX);
+        return false;
+    }
+    if (!isValidAircraftProfile(parsed)) {
+        snprintf(error, errorSize, "thresholds must increase and filter_window be 1 to %d", AOA_HISTORY_MAX);
+        return false;
+    }
+    profile = parsed;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool loadAircraftProfile(const char* path, AircraftProfile& profile, char* error, int errorSize) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        snprintf(error, errorSize, "can't open %s", path);
+        return false;
+    }
+    std::string text(AIRCRAFT_PROFILE_MAX_BYTES, '\0');
+    size_t size = fread(&text[0], 1, text.size(), file);
+    fclose(file);
+    text.resize(size);
+    return parseAircraftProfile(text.c_str(), profile, error, errorSize);
+}
+
+bool saveAircraftProfile(const char* path, const AircraftProfile& profile) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    const AoaThresholds& t = profile.thresholds;
+    fprintf(file, "# Fly On Speed aircraft profile\n");
+    if (profile.aircraft[0]) {
+        fprintf(file, "aircraft = %s\n", profile.aircraft);
+    }
+    fprintf(file, "below_ldmax = %.2f\n", t.belowLDMax);
+    fprintf(file, "below_onspeed = %.2f\n", t.belowOnSpeed);
+    fprintf(file, "onspeed_max = %.2f\n", t.onSpeedMax);
+    fprintf(file, "above_onspeed_max = %.2f\n", t.aboveOnSpeedMax);
+    fprintf(file, "ias_tone_enable = %.1f\n", t.iasToneEnable);
+    fprintf(file, "filter_window = %d\n", profile.filterWindow);
+    for (const ProfileKey& key : PROFILE_KEYS) {
+        if (key.tone) {
+            fprintf(file, "%s = %.2f\n", key.name, profile.tone.*key.tone);
+        }
+    }
+    return fclose(file) == 0;
+}
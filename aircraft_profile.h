@@ -0,0 +1,50 @@
+#ifndef AIRCRAFT_PROFILE_H
+#define AIRCRAFT_PROFILE_H
+
+#include "aoa_engine.h"
+
+#define AIRCRAFT_NAME_MAX       128
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Setpoints for one aircraft, stored as a short "key = value" text file so it can be read, diffed and edited
+// by hand:
+//
+//   # Fly On Speed aircraft profile
+//   aircraft = Cessna_172SP.acf
+//   below_ldmax = 6.0
+//   below_onspeed = 7.3
+//   onspeed_max = 9.6
+//   above_onspeed_max = 12.5
+//   ias_tone_enable = 25
+//   filter_window = 20
+//   tone_normal_hz = 400
+//   tone_high_hz = 1600
+//   pulse_rate_min = 1.5
+//   pulse_rate_max = 8.2
+//   above_onspeed_pulse_min = 1.5
+//   above_onspeed_pulse_max = 6.2
+//   pulse_rate_stall = 20
+//   volume = 1
+//
+// Unknown keys and # comments are skipped, missing keys keep the defaults.
+struct AircraftProfile {
+    char aircraft[AIRCRAFT_NAME_MAX];   // acf file name the profile is for, empty for any
+    AoaThresholds thresholds;
+    int filterWindow;                   // moving average length in frames
+    ToneSettings tone;
+};
+
+AircraftProfile defaultAircraftProfile();
+
+// Thresholds strictly increasing, the filter window in range and valid tone settings
+bool isValidAircraftProfile(const AircraftProfile& profile);
+
+// Parse profile text. Returns false, with the line at fault in error, if a value doesn't parse or the
+// result isn't valid.
+bool parseAircraftProfile(const char* text, AircraftProfile& profile, char* error, int errorSize);
+
+bool loadAircraftProfile(const char* path, AircraftProfile& profile, char* error, int errorSize);
+bool saveAircraftProfile(const char* path, const AircraftProfile& profile);
+
+#endif // AIRCRAFT_PROFILE_H
@@ -0,0 +1,100 @@
+#include "al_check.h"
+#include "logger.h"
+
+#include <chrono>
+#include <cstring>
+
+static std::atomic<AlCallSite*> sitesHead{nullptr};
+static std::atomic<AlErrorHandler> errorHandler{nullptr};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Sites are function-local statics, so this runs once per site and the list only ever grows
+AlCallSite::AlCallSite(const char* expression, const char* file, int line, bool isAlc)
+    : expression(expression),
+      file(file),
+      line(line),
+      isAlc(isAlc),
+      calls(0),
+      errors(0),
+      lastError(0),
+      lastLogMs(INT64_MIN / 2),
+      next(sitesHead.load(std::memory_order_relaxed)) {
+    while (!sitesHead.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void alCheckSetErrorHandler(AlErrorHandler handler) {
+    errorHandler.store(handler);
+}
+
+const AlCallSite* alCheckSites() {
+    return sitesHead.load(std::memory_order_acquire);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void alCheckResult(AlCallSite& site, int error) {
+    unsigned errors = site.errors.fetch_add(1, std::memory_order_relaxed) + 1;
+    site.lastError.store(error, std::memory_order_relaxed);
+
+    if (AlErrorHandler handler = errorHandler.load(std::memory_order_relaxed)) {
+        handler(site, error);
+    }
+
+#ifndef NDEBUG
+    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t lastMs = site.lastLogMs.load(std::memory_order_relaxed);
+    if (nowMs - lastMs >= AL_CHECK_LOG_INTERVAL_MS &&
+        site.lastLogMs.compare_exchange_strong(lastMs, nowMs, std::memory_order_relaxed)) {
+        const char* slash = strrchr(site.file, '/');
+        LOG_WARNING("AL error %s at %s:%d %s (%u so far)", alCheckErrorName(error, site.isAlc),
+                    slash ? slash + 1 : site.file, site.line, site.expression, errors);
+    }
+#else
+    (void)errors;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// One site each for AL and ALC, created the first time something is found pending
+void alCheckPending(int error, bool isAlc) {
+    if (isAlc) {
+        static AlCallSite alcSite("earlier unchecked ALC call", __FILE__, __LINE__, true);
+        alcSite.calls.fetch_add(1, std::memory_order_relaxed);
+        alCheckResult(alcSite, error);
+    } else {
+        static AlCallSite alSite("earlier unchecked AL call", __FILE__, __LINE__, false);
+        alSite.calls.fetch_add(1, std::memory_order_relaxed);
+        alCheckResult(alSite, error);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const char* alCheckErrorName(int error, bool isAlc) {
+    if (isAlc) {
+        switch (error) {
+            case ALC_NO_ERROR:          return "ALC_NO_ERROR";
+            case ALC_INVALID_DEVICE:    return "ALC_INVALID_DEVICE";
+            case ALC_INVALID_CONTEXT:   return "ALC_INVALID_CONTEXT";
+            case ALC_INVALID_ENUM:      return "ALC_INVALID_ENUM";
+            case ALC_INVALID_VALUE:     return "ALC_INVALID_VALUE";
+            case ALC_OUT_OF_MEMORY:     return "ALC_OUT_OF_MEMORY";
+        }
+    } else {
+        switch (error) {
+            case AL_NO_ERROR:           return "AL_NO_ERROR";
+            case AL_INVALID_NAME:       return "AL_INVALID_NAME";
+            case AL_INVALID_ENUM:       return "AL_INVALID_ENUM";
+            case AL_INVALID_VALUE:      return "AL_INVALID_VALUE";
+            case AL_INVALID_OPERATION:  return "AL_INVALID_OPERATION";
+            case AL_OUT_OF_MEMORY:      return "AL_OUT_OF_MEMORY";
+        }
+    }
+    return "unknown";
+}
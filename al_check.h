@@ -0,0 +1,98 @@
+#ifndef AL_CHECK_H
+#define AL_CHECK_H
+
+#if defined(__APPLE__)
+    #include <OpenAL/al.h>
+    #include <OpenAL/alc.h>
+#else
+    #include <AL/al.h>
+    #include <AL/alc.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+
+#define AL_CHECK_SAMPLE_INTERVAL    64      // Release builds check one call in this many per site, a power of two
+#define AL_CHECK_LOG_INTERVAL_MS    10000   // Debug builds log a failing site at most this often
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Checked OpenAL calls.
+//
+//   AL_CHECKED(alSourcePlay(audioSource));
+//   ALC_CHECKED(device, alcMakeContextCurrent(context));
+//
+// Each use is a call site with its own call and error counters. Debug builds call alGetError after every
+// call and log a failing site the first time and then at most every AL_CHECK_LOG_INTERVAL_MS. Release builds
+// only check one call in AL_CHECK_SAMPLE_INTERVAL per site and just count. alGetError takes the context lock,
+// so checking every call would cost more than the calls themselves. The AL error is sticky until read and shared
+// by every thread on the context, so a checked call reads it before the call too: whatever was already pending,
+// from an unchecked call here or on another thread, is counted against a separate "earlier unchecked call" site
+// rather than this one. Only an error another thread raises during the call itself can still be misattributed.
+struct AlCallSite {
+    AlCallSite(const char* expression, const char* file, int line, bool isAlc);
+
+    const char* expression;
+    const char* file;
+    int line;
+    bool isAlc;                         // error codes are ALC ones
+    std::atomic<unsigned> calls;
+    std::atomic<unsigned> errors;
+    std::atomic<int> lastError;
+    std::atomic<int64_t> lastLogMs;
+    AlCallSite* next;                   // every site that has run at least once
+};
+
+// Called on each failed check, e.g. to bump a metric
+typedef void (*AlErrorHandler)(const AlCallSite& site, int error);
+void alCheckSetErrorHandler(AlErrorHandler handler);
+
+// Count (and in debug builds log) an error found at a site
+void alCheckResult(AlCallSite& site, int error);
+
+// Count an error already pending before a checked call, against the earlier unchecked call site
+void alCheckPending(int error, bool isAlc);
+
+// Name of an AL or ALC error code
+const char* alCheckErrorName(int error, bool isAlc);
+
+// Sites seen so far, newest first
+const AlCallSite* alCheckSites();
+
+#ifdef NDEBUG
+#define AL_CHECK_SHOULD_TEST(site) \
+    (((site).calls.fetch_add(1, std::memory_order_relaxed) & (AL_CHECK_SAMPLE_INTERVAL - 1)) == 0)
+#else
+#define AL_CHECK_SHOULD_TEST(site) \
+    ((site).calls.fetch_add(1, std::memory_order_relaxed), true)
+#endif
+
+#define AL_CHECKED(call) \
+    do { \
+        static AlCallSite alCheckSite(#call, __FILE__, __LINE__, false); \
+        if (AL_CHECK_SHOULD_TEST(alCheckSite)) { \
+            ALenum alCheckError = alGetError(); \
+            if (alCheckError != AL_NO_ERROR) alCheckPending(alCheckError, false); \
+            call; \
+            alCheckError = alGetError(); \
+            if (alCheckError != AL_NO_ERROR) alCheckResult(alCheckSite, alCheckError); \
+        } else { \
+            call; \
+        } \
+    } while (0)
+
+#define ALC_CHECKED(device, call) \
+    do { \
+        static AlCallSite alCheckSite(#call, __FILE__, __LINE__, true); \
+        if (AL_CHECK_SHOULD_TEST(alCheckSite)) { \
+            ALCenum alCheckError = alcGetError(device); \
+            if (alCheckError != ALC_NO_ERROR) alCheckPending(alCheckError, true); \
+            call; \
+            alCheckError = alcGetError(device); \
+            if (alCheckError != ALC_NO_ERROR) alCheckResult(alCheckSite, alCheckError); \
+        } else { \
+            call; \
+        } \
+    } while (0)
+
+#endif // AL_CHECK_H
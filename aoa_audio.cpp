@@ -1,5 +1,4 @@
-#define FLYONSPEED_VERSION  "0.1.12"
-#define FLYONSPEED_DATE     "4/23/2025"
+#include "version.h"
 
 #define XPLM_64 1  // Define XPLM_64 as 1 for 64-bit compatibility
 #ifndef XPLM_API   
@@ -10,7 +9,6 @@
     #define PLUGIN_API __declspec(dllexport)
     #include <AL/al.h>
     #include <AL/alc.h>
-    #include <sstream>
     #include <cmath>
     #define _USE_MATH_DEFINES
     #define IBM 1
@@ -25,9 +23,12 @@
         #define LIN 0
         #define XPMENUS 1
         #define XPLM_64 1
+        #include <OpenAL/al.h>
+        #include <OpenAL/alc.h>
+    #else
+        #include <AL/al.h>
+        #include <AL/alc.h>
     #endif
-    #include <OpenAL/al.h>
-    #include <OpenAL/alc.h>
 #endif
 
 #include "SDK/CHeaders/XPLM/XPLMDisplay.h"
@@ -40,53 +41,162 @@
 #include "SDK/CHeaders/Widgets/XPStandardWidgets.h"
 #include "SDK/CHeaders/Widgets/XPWidgetUtils.h"
 #include "SDK/CHeaders/XPLM/XPLMMenus.h"
+#include "SDK/CHeaders/XPLM/XPLMPlanes.h"
+
+#include "al_check.h"
+#include "aircraft_profile.h"
+#include "aoa_calibration.h"
+#include "aoa_engine.h"
+#include "aoa_source.h"
+#include "aoa_source_analyzer.h"
+#include "dataref_set.h"
+#include "file_watcher.h"
+#include "flight_recorder.h"
+#include "frame_cost.h"
+#include "logger.h"
+#include "trace.h"
+#include "metrics.h"
+#include "phase_timer.h"
+#include "profile_store.h"
+#include "published_datarefs.h"
+#include "rcu_cell.h"
+#include "scope_window.h"
+#include "tape_window.h"
+#include "warm_state.h"
+#include "tone_renderer.h"
+#include "ui_presenter.h"
 
-#include <iostream>
 #include <cmath>
+#include <cstddef>
 #include <vector>
+#include <string>
 #include <cstring>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <ctime>
 
 // Function declarations
 void cleanupAudio();
 static void UpdateAOATextFields();
-
-// AOA ranges for different states (default values)
-float AOA_BELOW_LDMAX           = 6.0f;     // Below this is "Below LDMax" - no tone
-float AOA_BELOW_ONSPEED         = 7.3f;     // Between LDMax and this is "Below OnSpeed"
-float AOA_ONSPEED_MAX           = 9.6f;     // Between Below OnSpeed and this is "OnSpeed"
-float AOA_ABOVE_ONSPEED_MAX     = 12.5f;    // Above this is "Above OnSpeed"
-
-float AOA_IAS_TONE_ENABLE       = 25.0f;    // IAS (knots) above this value will enable the tone
-
-// Tone configuration
-#define TONE_NORMAL_FREQ       400.0f   // Normal frequency in Hz
-#define TONE_HIGH_FREQ         1600.0f  // High frequency in Hz
-#define PULSE_RATE_NORMAL      6.2f     // Standard pulse rate
-#define PULSE_RATE_STALL       20.0f    // Stall warning pulse rate
-#define DEFAULT_VOLUME          1.0f    // Default volume level (0.0 to 1.0)
-
-// Add these new constants
-#define PULSE_RATE_MIN         1.5f    // Minimum pulses per second at AOA_BELOW_LDMAX
-#define PULSE_RATE_MAX         8.2f    // Maximum pulses per second at AOA_BELOW_ONSPEED
-
-// Add these new constants near the other constants
-#define ABOVE_ONSPEED_PULSE_MIN  1.5f    // Minimum pulses per second at AOA_ONSPEED_MAX
-#define ABOVE_ONSPEED_PULSE_MAX  6.2f    // Maximum pulses per second at AOA_ABOVE_ONSPEED_MAX
+static void UpdateToneTextFields();
+static void SelectNextAoaSource();
+static void ToggleAoaCharacterization();
+static void ToggleAoaCalibration();
+static void FinishAoaCalibration();
+static void SaveAircraftProfile();
+static void ApplyToneSettings(const ToneSettings& settings);
+static void ToggleDebugSection();
+static void ToggleTrace();
+static void ToggleRecording();
+static void LogPhaseTimer(const PhaseTimer& timer);
+static void CountAlError(const AlCallSite& site, int error);
+static void LogAlErrorSites();
+
+// AOA ranges for different states. Only ever replaced whole, by PublishThresholds on the sim thread, and only
+// with a valid set, so the pulse thread reads them without a lock and can't see half an update.
+static RcuCell<AoaThresholds> thresholdCell(defaultAoaThresholds());
 
 // OpenAL device and context
 ALCdevice* device = nullptr;
 ALCcontext* context = nullptr;
 ALuint audioSource;
-ALuint audioBufferNormal;  // Rename existing audioBuffer
-ALuint audioBufferHigh;    // New buffer for high frequency
 
-// DataRef for AOA and IAS (indicated airspeed)
-XPLMDataRef aoaDataRef = nullptr;
-XPLMDataRef iasDataRef = nullptr;
-XPLMDataRef aircraftNameDataRef = nullptr;
+// Tone frequencies, pulse rates and volume, and the buffers rendered for them. The sim thread writes both under
+// toneMutex and reads them without it; the pulse thread reads them, and attaches buffers, under toneMutex, so
+// once a swap has gone through nothing can attach the old buffers again.
+static ToneSettings toneSettings = defaultToneSettings();
+static ToneBuffers toneBuffers = {};
+static std::mutex toneMutex;
+static ToneRenderer toneRenderer;
+
+// Frequencies of the newest render asked for, or of toneBuffers if none is in flight. Sim thread only.
+// Compared instead of toneBuffers so changing a frequency and back before the render lands asks again.
+static float toneRequestedNormal = 0.0f;
+static float toneRequestedHigh = 0.0f;
+
+// Everything the flight loop reads from the sim, filled in one pass per frame
+struct FlightData {
+    float aoaSources[AOA_SOURCE_COUNT];     // degrees, one per AOA_SOURCES entry
+    float ias;                              // knots
+    float gLoad;                            // normal load factor, recorded only
+    float flapRatio;                        // 0 up to 1 full, recorded only
+};
+
+// here is a site that shows a list of DataRefs:
+// https://siminnovations.com/xplane/dataref/index.php
+// The AOA sources come first so their index in this table matches AOA_SOURCES.
+// alpha is always there, the gauge datarefs depend on the aircraft.
+static const DataRefSpec flightDataRefs[] = {
+    {AOA_SOURCES[0].dataRef, offsetof(FlightData, aoaSources) + 0 * sizeof(float), DataRefKind::Scalar, 1, 0, true},
+    {AOA_SOURCES[1].dataRef, offsetof(FlightData, aoaSources) + 1 * sizeof(float), DataRefKind::Scalar, 1, 0, false},
+    {AOA_SOURCES[2].dataRef, offsetof(FlightData, aoaSources) + 2 * sizeof(float), DataRefKind::Scalar, 1, 0, false},
+    {"sim/flightmodel/position/indicated_airspeed", offsetof(FlightData, ias), DataRefKind::Scalar, 1, 0, true},
+    {"sim/flightmodel/forces/g_nrml", offsetof(FlightData, gLoad), DataRefKind::Scalar, 1, 0, false},
+    {"sim/cockpit2/controls/flap_ratio", offsetof(FlightData, flapRatio), DataRefKind::Scalar, 1, 0, false},
+};
+static const int FLIGHT_DATA_G_LOAD = AOA_SOURCE_COUNT + 1;    // index of g_nrml above
+static DataRefSet flightDataSet(flightDataRefs, sizeof(flightDataRefs) / sizeof(flightDataRefs[0]));
+static FlightData flightData = {};
+
+// Engine outputs, published as flyonspeed/* datarefs so other plugins and instruments don't recompute them.
+// Written once per frame by the flight loop, read lock-free by the dataref accessors.
+static std::atomic<float> publishedAoaFiltered{0.0f};
+static std::atomic<int> publishedToneZone{0};
+static std::atomic<float> publishedPulseRate{0.0f};
+static std::atomic<float> publishedFrequency{0.0f};
+static std::atomic<float> publishedFrameCostMin{0.0f};
+static std::atomic<float> publishedFrameCostMean{0.0f};
+static std::atomic<float> publishedFrameCostP99{0.0f};
+static std::atomic<float> publishedFrameCostMax{0.0f};
+static std::atomic<int> publishedFramesOverBudget{0};
+static std::atomic<float> publishedBelowLDMax{0.0f};
+static std::atomic<float> publishedBelowOnSpeed{0.0f};
+static std::atomic<float> publishedOnSpeedMax{0.0f};
+static std::atomic<float> publishedAboveOnSpeedMax{0.0f};
+static std::atomic<float> publishedIasToneEnable{0.0f};
+static PublishedDataRefs publishedDataRefs;
+
+// Wall time of each CheckAOAAndPlayTone call
+static FrameCostStats frameCost;
+
+// Counters for diagnosing field reports, published as flyonspeed/metrics/<name> and shown in the debug section
+static MetricsRegistry metrics;
+static const int metricFrames = metrics.addCounter("frames", "Frames");
+static const int metricSpikesRejected = metrics.addCounter("spikes_rejected", "Spikes rejected");
+static const int metricZoneTransitions = metrics.addCounter("zone_transitions", "Zone transitions");
+static const int metricBufferSwitches = metrics.addCounter("buffer_switches", "Buffer switches");
+static const int metricAlErrors = metrics.addCounter("al_errors", "AL errors");
+static const int metricPulses = metrics.addCounter("pulses", "Pulses");
+static const int metricLatePulses = metrics.addCounter("late_pulses", "Late pulses");
+static const int metricPulseLateMs = metrics.addGauge("pulse_late_ms", "Last pulse late ms");
+
+// Optional per-frame flight data recording, toggled from the menu
+static FlightRecorder flightRecorder;
+static double recordingTime = 0.0;     // flight loop seconds since recording started, FlightRecord::time
+
+#define PULSE_LATE_MS   5.0f    // A pulse starting this much after it was due counts as late
+
+// Which AOA_SOURCES entry drives the tone
+static int aoaSourceIndex = 0;
+static AoaSourceCharacterizer aoaCharacterizer;
+static AoaSourceAnalyzer aoaAnalyzer;      // compares the sources over a finished segment, off the sim thread
+
+// Setpoint calibration from a deceleration to the stall
+static AoaCalibration aoaCalibration;
+
+// Setpoints and filter window per aircraft, in Output/preferences/FlyOnSpeed/<acf name>.profile.
+// Read and written on the store's thread, applied here in the flight loop.
+static ProfileStore profileStore;
+static char profileAircraft[AIRCRAFT_NAME_MAX] = "";    // acf file name of the user aircraft
+static char profilePath[PROFILE_PATH_MAX] = "";
+
+// Picks up edits to the profile made outside the sim, so they apply without Reload Plugins
+static FileWatcher profileWatcher;
+static bool profileHotReload = false;   // the pending load came from the watcher, not an aircraft load
+static char warmStateAircraft[AIRCRAFT_NAME_MAX] = "";  // its first profile load mustn't undo the warm state
 
 // Add these globals for the UI
 static XPWidgetID audioControlWidget = nullptr;
@@ -94,24 +204,24 @@ static XPWidgetID audioToggleCheckbox = nullptr;
 static XPWidgetID widgetAOAValue = nullptr;
 static XPWidgetID widgetButtonReload = nullptr;
 static XPWidgetID widgetAudioStatus = nullptr;
+static XPWidgetID widgetFrameCost = nullptr;
 static bool audioEnabled = false;
 static XPLMMenuID menuId;
 
-// Add these globals at the top of the file with other globals
-const int AOA_HISTORY_SIZE = 20;
-std::vector<float> aoaHistory;
-float lastValidAoa = 0.0f;
-const float MAX_AOA_CHANGE = 6.0f;  // Maximum allowed change in degrees
+// Spike filter and moving average, fixed size so the flight loop never allocates
+AoaFilter aoaFilter;
 
 // Add these globals with other globals
 std::thread* pulseThread = nullptr;
 std::mutex aoaMutex;
 std::atomic<bool> threadRunning{false};
+std::mutex pulseWakeMutex;
+std::condition_variable pulseWake;      // notified when threadRunning goes false so stop doesn't wait out a pulse
 std::atomic<float> currentAOA{0.0f};
-std::atomic<bool> shouldPlay{false};
 
-float audioFrequency = TONE_NORMAL_FREQ;
-float audioPulseRate = PULSE_RATE_NORMAL;
+// Zone the flight loop last computed, kept across a plugin reload by the warm state snapshot
+static ToneZone lastToneZone = ToneZone::BelowIAS;
+std::atomic<bool> shouldPlay{false};
 
 // Add these globals with other globals
 static int lastWidgetBottom = 0;
@@ -126,6 +236,30 @@ static XPWidgetID widgetAOAAboveOnSpeedMax = nullptr;
 static XPWidgetID widgetAOAStallWarning = nullptr;
 static XPWidgetID widgetAOAIASToneEnable = nullptr;
 static XPWidgetID widgetButtonUpdateValues = nullptr;
+static XPWidgetID widgetButtonAoaSource = nullptr;
+static XPWidgetID widgetButtonCharacterize = nullptr;
+static XPWidgetID widgetButtonCalibrate = nullptr;
+static XPWidgetID widgetButtonDebug = nullptr;
+static XPWidgetID widgetMetrics[METRICS_MAX] = {};
+
+// Tone settings the window can edit, in the order they are shown
+struct ToneField {
+    const char* label;
+    float ToneSettings::*value;
+    const char* format;
+};
+static const ToneField TONE_FIELDS[] = {
+    {"Low Tone Hz:", &ToneSettings::normalFrequency, "%.0f"},
+    {"High Tone Hz:", &ToneSettings::highFrequency, "%.0f"},
+    {"Slow PPS Min:", &ToneSettings::belowOnSpeedPulseMin, "%.1f"},
+    {"Slow PPS Max:", &ToneSettings::belowOnSpeedPulseMax, "%.1f"},
+    {"Fast PPS Min:", &ToneSettings::aboveOnSpeedPulseMin, "%.1f"},
+    {"Fast PPS Max:", &ToneSettings::aboveOnSpeedPulseMax, "%.1f"},
+    {"Stall PPS:", &ToneSettings::stallPulseRate, "%.1f"},
+    {"Volume:", &ToneSettings::volume, "%.2f"},
+};
+static const int TONE_FIELD_COUNT = sizeof(TONE_FIELDS) / sizeof(TONE_FIELDS[0]);
+static XPWidgetID widgetToneFields[TONE_FIELD_COUNT] = {};
 
 // Temporary variables to store text field values
 static float temp_AOA_BELOW_LDMAX = 0.0f;
@@ -134,21 +268,40 @@ static float temp_AOA_ONSPEED_MAX = 0.0f;
 static float temp_AOA_ABOVE_ONSPEED_MAX = 0.0f;
 static float temp_AOA_IAS_TONE_ENABLE = 0.0f;
 
+// Live AOA and audio status captions, throttled and skipped while the window is hidden
+static UiPresenter uiPresenter;
+static TapeWindow tapeWindow;
+
+// Last minute or so of frames for the scope window, filled whether it is open or not
+static ScopeBuffer scopeBuffer;
+static ScopeWindow scopeWindow(scopeBuffer);
+static double scopeTime = 0.0;
+static int scopePulsesSeen = 0;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Function to generate a sine wave tone
-std::vector<ALshort> generateTone(float frequency, float duration, int sampleRate = 44100) {
-    std::vector<ALshort> buffer;
-    int samples = static_cast<int>(duration * sampleRate);
-    buffer.reserve(samples);
-    
-    for (int i = 0; i < samples; i++) {
-        float t = static_cast<float>(i) / sampleRate;
-        float value = 32767.0f * std::sin(2.0f * M_PI * frequency * t);
-        buffer.push_back(static_cast<ALshort>(value));
+// Snapshot the threshold globals for the engine
+static AoaThresholds currentThresholds() {
+    return *thresholdCell.read();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Replace the thresholds if the new set is valid. Sim thread only.
+static bool PublishThresholds(const AoaThresholds& thresholds) {
+    if (!isValidAoaThresholds(thresholds)) {
+        LOG_WARNING("AOA values not changed: Below LDMax < Below OnSpeed < OnSpeed Max < Above OnSpeed must hold, "
+                    "got %.1f, %.1f, %.1f, %.1f", thresholds.belowLDMax, thresholds.belowOnSpeed,
+                    thresholds.onSpeedMax, thresholds.aboveOnSpeedMax);
+        return false;
     }
-    
-    return buffer;
+    thresholdCell.publish(thresholds);
+    publishedBelowLDMax.store(thresholds.belowLDMax, std::memory_order_relaxed);
+    publishedBelowOnSpeed.store(thresholds.belowOnSpeed, std::memory_order_relaxed);
+    publishedOnSpeedMax.store(thresholds.onSpeedMax, std::memory_order_relaxed);
+    publishedAboveOnSpeedMax.store(thresholds.aboveOnSpeedMax, std::memory_order_relaxed);
+    publishedIasToneEnable.store(thresholds.iasToneEnable, std::memory_order_relaxed);
+    return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -156,74 +309,114 @@ std::vector<ALshort> generateTone(float frequency, float duration, int sampleRat
 // Function to initialize OpenAL and create tone
 static float init_sound(float elapsed, float elapsed_sim, int counter, void * ref)
 {
+    PhaseTimer timer("Audio init");
+
     device = alcOpenDevice(nullptr);
-    XPLMDebugString("FlyOnSpeed: Initializing audio device\n");
+    LOG_INFO("Initializing audio device");
     if (!device) {
-        XPLMDebugString("FlyOnSpeed: Failed to open device\n");
+        LOG_ERROR("Failed to open device");
         return false;
     }
     
     context = alcCreateContext(device, nullptr);
-    XPLMDebugString("FlyOnSpeed: Creating audio context\n");
+    LOG_INFO("Creating audio context");
     if (!context) {
-        XPLMDebugString("FlyOnSpeed: Failed to create context\n");
+        LOG_ERROR("Failed to create context");
         alcCloseDevice(device);
         return false;
     }
     
-    alcMakeContextCurrent(context);
+    ALC_CHECKED(device, alcMakeContextCurrent(context));
+    timer.mark("device");
 
     // Generate source and buffers
-    alGenSources(1, &audioSource);
-    alGenBuffers(1, &audioBufferNormal);
-    alGenBuffers(1, &audioBufferHigh);
+    AL_CHECKED(alGenSources(1, &audioSource));
     
     // Set the initial volume (gain)
-    alSourcef(audioSource, AL_GAIN, DEFAULT_VOLUME);
-    
-    // Create normal frequency tone
-    auto toneNormal = generateTone(TONE_NORMAL_FREQ, 0.1f);
-    alBufferData(audioBufferNormal, AL_FORMAT_MONO16, toneNormal.data(), 
-                 toneNormal.size() * sizeof(ALshort), 44100);
-                 
-    // Create high frequency tone
-    auto toneHigh = generateTone(TONE_HIGH_FREQ, 0.1f);
-    alBufferData(audioBufferHigh, AL_FORMAT_MONO16, toneHigh.data(), 
-                 toneHigh.size() * sizeof(ALshort), 44100);
+    AL_CHECKED(alSourcef(audioSource, AL_GAIN, toneSettings.volume));
+    
+    // Normal and high frequency tones. Later changes are rendered in the background by toneRenderer.
+    ToneBuffers buffers;
+    if (!ToneRenderer::render(toneSettings.normalFrequency, toneSettings.highFrequency, buffers)) {
+        LOG_ERROR("Failed to create tone buffers");
+    } else {
+        std::lock_guard<std::mutex> lock(toneMutex);
+        toneBuffers = buffers;
+    }
+    toneRequestedNormal = toneBuffers.normalFrequency;
+    toneRequestedHigh = toneBuffers.highFrequency;
     
     // Set initial buffer
-    alSourcei(audioSource, AL_BUFFER, audioBufferNormal);
+    AL_CHECKED(alSourcei(audioSource, AL_BUFFER, toneBuffers.normal));
     
     // Configure source to loop
-    alSourcei(audioSource, AL_LOOPING, AL_FALSE);
+    AL_CHECKED(alSourcei(audioSource, AL_LOOPING, AL_FALSE));
+    timer.mark("buffers");
+
+    LogPhaseTimer(timer);
     
     return 0.0f;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void LogPhaseTimer(const PhaseTimer& timer) {
+    char text[256];
+    timer.format(text, sizeof(text));
+    LOG_INFO("%s", text);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Error handler for the checked AL calls, runs on whichever thread made the call
+static void CountAlError(const AlCallSite&, int) {
+    metrics.increment(metricAlErrors);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// One line per AL call site that failed a check this session
+static void LogAlErrorSites() {
+    for (const AlCallSite* site = alCheckSites(); site; site = site->next) {
+        unsigned errors = site->errors.load(std::memory_order_relaxed);
+        if (errors == 0) {
+            continue;
+        }
+        const char* slash = strrchr(site->file, '/');
+        LOG_WARNING("%u AL errors at %s:%d %s, last %s (%u calls)", errors, slash ? slash + 1 : site->file,
+                    site->line, site->expression,
+                    alCheckErrorName(site->lastError.load(std::memory_order_relaxed), site->isAlc),
+                    site->calls.load(std::memory_order_relaxed));
+    }
+}
+
+#ifndef NDEBUG
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Every widget message comes through here, mouse and draw traffic included, so this is debug-only
 static void printMessageDescription(XPWidgetMessage msg) {
     switch(msg) {
         case xpMessage_CloseButtonPushed:
-            XPLMDebugString("FlyOnSpeed: xpMessage_CloseButtonPushed\n");
+            LOG_DEBUG("xpMessage_CloseButtonPushed");
             break;
         case xpMsg_PushButtonPressed:
-            XPLMDebugString("FlyOnSpeed: xpMsg_PushButtonPressed\n");
+            LOG_DEBUG("xpMsg_PushButtonPressed");
             break;
         case xpMsg_ButtonStateChanged:
-            XPLMDebugString("FlyOnSpeed: xpMsg_ButtonStateChanged\n");
+            LOG_DEBUG("xpMsg_ButtonStateChanged");
             break;
         case xpMsg_TextFieldChanged:
-            XPLMDebugString("FlyOnSpeed: xpMsg_TextFieldChanged\n");
+            LOG_DEBUG("xpMsg_TextFieldChanged");
             break;
         case xpMsg_ScrollBarSliderPositionChanged:
-            XPLMDebugString("FlyOnSpeed: xpMsg_ScrollBarSliderPositionChanged\n");
+            LOG_DEBUG("xpMsg_ScrollBarSliderPositionChanged");
             break;
         default:
-            XPLMDebugString(("FlyOnSpeed: Unknown message type: " + std::to_string(msg) + "\n").c_str());
+            LOG_DEBUG("Unknown message type: %d", static_cast<int>(msg));
             break;
     }
 }
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -234,15 +427,16 @@ static int AudioControlHandler(
     intptr_t inParam1,
     intptr_t inParam2)
 {
+#ifndef NDEBUG
     printMessageDescription(inMessage);
-    //XPLMDebugString(("FlyOnSpeed: AudioControlHandler. Message: " + std::to_string(inMessage) + "\n").c_str());
+#endif
     if (inMessage == xpMessage_CloseButtonPushed) {
         XPHideWidget(audioControlWidget);
         return 1;
     }
 
     if (inMessage == xpMsg_PushButtonPressed) {
-        XPLMDebugString(("FlyOnSpeed: AudioControlHandler. Button state changed " + std::to_string(inParam1) + "\n").c_str());
+        LOG_DEBUG("AudioControlHandler. Button state changed %ld", static_cast<long>(inParam1));
         if (inParam1 == (intptr_t)audioToggleCheckbox) {
             audioEnabled = !audioEnabled;
             //audioEnabled = XPGetWidgetProperty(audioToggleCheckbox, xpProperty_ButtonState, nullptr);
@@ -250,65 +444,92 @@ static int AudioControlHandler(
             if(audioEnabled) XPSetWidgetDescriptor(audioToggleCheckbox, "Sound: On");
             else XPSetWidgetDescriptor(audioToggleCheckbox, "Sound: Off");
 
-            XPLMDebugString(("FlyOnSpeed: AudioControlHandler. Button state: " + std::to_string(audioEnabled) + "\n").c_str());
+            LOG_INFO("AudioControlHandler. Button state: %d", audioEnabled ? 1 : 0);
+            return 1;
+        }
+        else if (inParam1 == (intptr_t)widgetButtonAoaSource) {
+            SelectNextAoaSource();
+            return 1;
+        }
+        else if (inParam1 == (intptr_t)widgetButtonCharacterize) {
+            ToggleAoaCharacterization();
+            return 1;
+        }
+        else if (inParam1 == (intptr_t)widgetButtonCalibrate) {
+            ToggleAoaCalibration();
+            return 1;
+        }
+        else if (inParam1 == (intptr_t)widgetButtonDebug) {
+            ToggleDebugSection();
             return 1;
         }
         // Add handler for reload button
         else if (inParam1 == (intptr_t)widgetButtonReload) {
-            XPLMDebugString("FlyOnSpeed: Reloading plugins\n");
+            LOG_INFO("Reloading plugins");
             XPLMReloadPlugins();
             return 1;
         }
         // Add handler for update values button
         else if (inParam1 == (intptr_t)widgetButtonUpdateValues) {
-            XPLMDebugString("FlyOnSpeed: Updating AOA values\n");
+            LOG_INFO("Updating AOA values");
             
-            // Directly read from text fields when updating
+            // Directly read from text fields when updating, into a copy that is published in one go
             char buffer[32];
             float value;
+            AoaThresholds updated = currentThresholds();
             
             // Get Below LDMax value
             XPGetWidgetDescriptor(widgetAOABelowLDMax, buffer, sizeof(buffer));
             value = atof(buffer);
-            if (value > 0) AOA_BELOW_LDMAX = value;
+            if (value > 0) updated.belowLDMax = value;
             
             // Get Below OnSpeed value
             XPGetWidgetDescriptor(widgetAOABelowOnSpeed, buffer, sizeof(buffer));
             value = atof(buffer);
-            if (value > 0) AOA_BELOW_ONSPEED = value;
+            if (value > 0) updated.belowOnSpeed = value;
             
             // Get OnSpeed Max value
             XPGetWidgetDescriptor(widgetAOAOnSpeedMax, buffer, sizeof(buffer));
             value = atof(buffer);
-            if (value > 0) AOA_ONSPEED_MAX = value;
+            if (value > 0) updated.onSpeedMax = value;
             
             // Get Above OnSpeed Max value
             XPGetWidgetDescriptor(widgetAOAAboveOnSpeedMax, buffer, sizeof(buffer));
             value = atof(buffer);
-            if (value > 0) AOA_ABOVE_ONSPEED_MAX = value;
+            if (value > 0) updated.aboveOnSpeedMax = value;
                         
             // Get IAS Tone Enable value
             XPGetWidgetDescriptor(widgetAOAIASToneEnable, buffer, sizeof(buffer));
             value = atof(buffer);
-            if (value > 0) AOA_IAS_TONE_ENABLE = value;
+            if (value > 0) updated.iasToneEnable = value;
             
-            // Debug output to check values
-            char debugMsg[256];
-            snprintf(debugMsg, sizeof(debugMsg), 
-                     "FlyOnSpeed: Updated values - IAS Enable: %.1f, Below LDMax: %.1f, Below OnSpeed: %.1f, OnSpeed Max: %.1f, Above OnSpeed: %.1f\n",
-                     AOA_IAS_TONE_ENABLE, AOA_BELOW_LDMAX, AOA_BELOW_ONSPEED, AOA_ONSPEED_MAX, AOA_ABOVE_ONSPEED_MAX);
-            XPLMDebugString(debugMsg);
+            if (PublishThresholds(updated)) {
+                LOG_INFO("Updated values - IAS Enable: %.1f, Below LDMax: %.1f, Below OnSpeed: %.1f, OnSpeed Max: %.1f, Above OnSpeed: %.1f",
+                         updated.iasToneEnable, updated.belowLDMax, updated.belowOnSpeed, updated.onSpeedMax,
+                         updated.aboveOnSpeedMax);
+            }
+            const AoaThresholds current = currentThresholds();
             
+            // Tone fields are taken all together, or not at all if the set isn't valid
+            ToneSettings tone = toneSettings;
+            for (int i = 0; i < TONE_FIELD_COUNT; i++) {
+                XPGetWidgetDescriptor(widgetToneFields[i], buffer, sizeof(buffer));
+                tone.*TONE_FIELDS[i].value = static_cast<float>(atof(buffer));
+            }
+            ApplyToneSettings(tone);
+
             // Update the temporary variables to match the new values
-            temp_AOA_BELOW_LDMAX = AOA_BELOW_LDMAX;
-            temp_AOA_BELOW_ONSPEED = AOA_BELOW_ONSPEED;
-            temp_AOA_ONSPEED_MAX = AOA_ONSPEED_MAX;
-            temp_AOA_ABOVE_ONSPEED_MAX = AOA_ABOVE_ONSPEED_MAX;
-            temp_AOA_IAS_TONE_ENABLE = AOA_IAS_TONE_ENABLE;
+            temp_AOA_BELOW_LDMAX = current.belowLDMax;
+            temp_AOA_BELOW_ONSPEED = current.belowOnSpeed;
+            temp_AOA_ONSPEED_MAX = current.onSpeedMax;
+            temp_AOA_ABOVE_ONSPEED_MAX = current.aboveOnSpeedMax;
+            temp_AOA_IAS_TONE_ENABLE = current.iasToneEnable;
             
             // Update the display with the new values
             UpdateAOATextFields();
-            
+            uiPresenter.invalidate();
+
+            SaveAircraftProfile();
             return 1;
         }
     }
@@ -322,7 +543,7 @@ static int AudioControlHandler(
             value = atof(buffer);
             if (value > 0) {
                 temp_AOA_BELOW_LDMAX = value;
-                XPLMDebugString(("FlyOnSpeed: Text field changed - Below LDMax: " + std::to_string(value) + "\n").c_str());
+                LOG_DEBUG("Text field changed - Below LDMax: %.1f", value);
             }
         }
         else if (inParam1 == (intptr_t)widgetAOABelowOnSpeed) {
@@ -330,7 +551,7 @@ static int AudioControlHandler(
             value = atof(buffer);
             if (value > 0) {
                 temp_AOA_BELOW_ONSPEED = value;
-                XPLMDebugString(("FlyOnSpeed: Text field changed - Below OnSpeed: " + std::to_string(value) + "\n").c_str());
+                LOG_DEBUG("Text field changed - Below OnSpeed: %.1f", value);
             }
         }
         else if (inParam1 == (intptr_t)widgetAOAOnSpeedMax) {
@@ -338,7 +559,7 @@ static int AudioControlHandler(
             value = atof(buffer);
             if (value > 0) {
                 temp_AOA_ONSPEED_MAX = value;
-                XPLMDebugString(("FlyOnSpeed: Text field changed - OnSpeed Max: " + std::to_string(value) + "\n").c_str());
+                LOG_DEBUG("Text field changed - OnSpeed Max: %.1f", value);
             }
         }
         else if (inParam1 == (intptr_t)widgetAOAAboveOnSpeedMax) {
@@ -346,7 +567,7 @@ static int AudioControlHandler(
             value = atof(buffer);
             if (value > 0) {
                 temp_AOA_ABOVE_ONSPEED_MAX = value;
-                XPLMDebugString(("FlyOnSpeed: Text field changed - Above OnSpeed: " + std::to_string(value) + "\n").c_str());
+                LOG_DEBUG("Text field changed - Above OnSpeed: %.1f", value);
             }
         }
         else if (inParam1 == (intptr_t)widgetAOAIASToneEnable) {
@@ -354,7 +575,7 @@ static int AudioControlHandler(
             value = atof(buffer);
             if (value > 0) {
                 temp_AOA_IAS_TONE_ENABLE = value;
-                XPLMDebugString(("FlyOnSpeed: Text field changed - IAS Tone Enable: " + std::to_string(value) + "\n").c_str());
+                LOG_DEBUG("Text field changed - IAS Tone Enable: %.1f", value);
             }
         }
         
@@ -448,7 +669,7 @@ static XPWidgetID createLabeledTextField(const char* label, float value, int lef
     snprintf(valueText, sizeof(valueText), "%.1f", value);
     XPSetWidgetDescriptor(textField, valueText);
     
-    XPLMDebugString(("FlyOnSpeed: Created text field for " + std::string(label) + " with initial value " + valueText + "\n").c_str());
+    LOG_DEBUG("Created text field for %s with initial value %s", label, valueText);
     
     return textField;
 }
@@ -490,13 +711,23 @@ static void CreateAudioControlWindow(int x, int y, int w, int h) {
         xpWidgetClass_Caption,
         "" 
     );
+
+    widgetFrameCost = createWidget(
+        xpWidgetClass_Caption,
+        ""
+    );
     
     // Add text fields for editing AOA threshold values
-    widgetAOABelowLDMax = createLabeledTextField("Below LDMax:", AOA_BELOW_LDMAX);
-    widgetAOABelowOnSpeed = createLabeledTextField("Below OnSpeed:", AOA_BELOW_ONSPEED);
-    widgetAOAOnSpeedMax = createLabeledTextField("OnSpeed Max:", AOA_ONSPEED_MAX);
-    widgetAOAAboveOnSpeedMax = createLabeledTextField("Above OnSpeed:", AOA_ABOVE_ONSPEED_MAX);
-    widgetAOAIASToneEnable = createLabeledTextField("IAS Tone Enable:", AOA_IAS_TONE_ENABLE);
+    const AoaThresholds thresholds = currentThresholds();
+    widgetAOABelowLDMax = createLabeledTextField("Below LDMax:", thresholds.belowLDMax);
+    widgetAOABelowOnSpeed = createLabeledTextField("Below OnSpeed:", thresholds.belowOnSpeed);
+    widgetAOAOnSpeedMax = createLabeledTextField("OnSpeed Max:", thresholds.onSpeedMax);
+    widgetAOAAboveOnSpeedMax = createLabeledTextField("Above OnSpeed:", thresholds.aboveOnSpeedMax);
+    widgetAOAIASToneEnable = createLabeledTextField("IAS Tone Enable:", thresholds.iasToneEnable);
+    for (int i = 0; i < TONE_FIELD_COUNT; i++) {
+        widgetToneFields[i] = createLabeledTextField(TONE_FIELDS[i].label, toneSettings.*TONE_FIELDS[i].value);
+    }
+    UpdateToneTextFields();
     
     // Add the Update Values button
     widgetButtonUpdateValues = createWidget(
@@ -506,15 +737,67 @@ static void CreateAudioControlWindow(int x, int y, int w, int h) {
     
     audioToggleCheckbox = createWidget(
         xpWidgetClass_Button,
-        "Sound: Off"
+        audioEnabled ? "Sound: On" : "Sound: Off"
+    );
+
+    char sourceText[50];
+    snprintf(sourceText, sizeof(sourceText), "AOA Source: %s", AOA_SOURCES[aoaSourceIndex].label);
+    widgetButtonAoaSource = createWidget(
+        xpWidgetClass_Button,
+        sourceText
+    );
+
+    widgetButtonCharacterize = createWidget(
+        xpWidgetClass_Button,
+        aoaCharacterizer.isRunning() ? "Characterize: Stop" : "Characterize: Start"
+    );
+
+    widgetButtonCalibrate = createWidget(
+        xpWidgetClass_Button,
+        aoaCalibration.isRunning() ? "Calibrate: Stop" : "Calibrate: Start"
     );
     
     widgetButtonReload = createWidget(
         xpWidgetClass_Button,
         "Reload Plugins"
     );
+
+    // Collapsible debug section, starts hidden
+    widgetButtonDebug = createWidget(
+        xpWidgetClass_Button,
+        "Debug: Show"
+    );
+    for (int i = 0; i < metrics.size(); i++) {
+        widgetMetrics[i] = createWidget(xpWidgetClass_Caption, "");
+        XPHideWidget(widgetMetrics[i]);
+    }
     
     XPAddWidgetCallback(audioControlWidget, AudioControlHandler);
+
+    uiPresenter.attach(audioControlWidget, widgetAOAValue, widgetAudioStatus, widgetFrameCost);
+    uiPresenter.attachMetrics(&metrics, widgetMetrics);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Show or hide the metric captions and grow or shrink the window to fit them
+static void ToggleDebugSection() {
+    bool show = !XPIsWidgetVisible(widgetMetrics[0]);
+    for (int i = 0; i < metrics.size(); i++) {
+        if (show) {
+            XPShowWidget(widgetMetrics[i]);
+        } else {
+            XPHideWidget(widgetMetrics[i]);
+        }
+    }
+
+    int left, top, right, bottom;
+    XPGetWidgetGeometry(audioControlWidget, &left, &top, &right, &bottom);
+    int sectionHeight = metrics.size() * (WIDGET_HEIGHT + WIDGET_MARGIN);
+    XPSetWidgetGeometry(audioControlWidget, left, top, right, show ? bottom - sectionHeight : bottom + sectionHeight);
+
+    XPSetWidgetDescriptor(widgetButtonDebug, show ? "Debug: Hide" : "Debug: Show");
+    uiPresenter.invalidate();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -526,28 +809,479 @@ static void UpdateAOATextFields() {
     }
     
     char buffer[16];
+    const AoaThresholds t = currentThresholds();
     
     // Initialize temporary variables with current values
-    temp_AOA_BELOW_LDMAX = AOA_BELOW_LDMAX;
-    temp_AOA_BELOW_ONSPEED = AOA_BELOW_ONSPEED;
-    temp_AOA_ONSPEED_MAX = AOA_ONSPEED_MAX;
-    temp_AOA_ABOVE_ONSPEED_MAX = AOA_ABOVE_ONSPEED_MAX;
-    temp_AOA_IAS_TONE_ENABLE = AOA_IAS_TONE_ENABLE;
+    temp_AOA_BELOW_LDMAX = t.belowLDMax;
+    temp_AOA_BELOW_ONSPEED = t.belowOnSpeed;
+    temp_AOA_ONSPEED_MAX = t.onSpeedMax;
+    temp_AOA_ABOVE_ONSPEED_MAX = t.aboveOnSpeedMax;
+    temp_AOA_IAS_TONE_ENABLE = t.iasToneEnable;
     
-    snprintf(buffer, sizeof(buffer), "%.1f", AOA_BELOW_LDMAX);
+    snprintf(buffer, sizeof(buffer), "%.1f", t.belowLDMax);
     XPSetWidgetDescriptor(widgetAOABelowLDMax, buffer);
     
-    snprintf(buffer, sizeof(buffer), "%.1f", AOA_BELOW_ONSPEED);
+    snprintf(buffer, sizeof(buffer), "%.1f", t.belowOnSpeed);
     XPSetWidgetDescriptor(widgetAOABelowOnSpeed, buffer);
     
-    snprintf(buffer, sizeof(buffer), "%.1f", AOA_ONSPEED_MAX);
+    snprintf(buffer, sizeof(buffer), "%.1f", t.onSpeedMax);
     XPSetWidgetDescriptor(widgetAOAOnSpeedMax, buffer);
     
-    snprintf(buffer, sizeof(buffer), "%.1f", AOA_ABOVE_ONSPEED_MAX);
+    snprintf(buffer, sizeof(buffer), "%.1f", t.aboveOnSpeedMax);
     XPSetWidgetDescriptor(widgetAOAAboveOnSpeedMax, buffer);
         
-    snprintf(buffer, sizeof(buffer), "%.1f", AOA_IAS_TONE_ENABLE);
+    snprintf(buffer, sizeof(buffer), "%.1f", t.iasToneEnable);
     XPSetWidgetDescriptor(widgetAOAIASToneEnable, buffer);
+
+    UpdateToneTextFields();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void UpdateToneTextFields() {
+    if (!audioControlWidget) {
+        return;
+    }
+    char buffer[16];
+    for (int i = 0; i < TONE_FIELD_COUNT; i++) {
+        snprintf(buffer, sizeof(buffer), TONE_FIELDS[i].format, toneSettings.*TONE_FIELDS[i].value);
+        XPSetWidgetDescriptor(widgetToneFields[i], buffer);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Take new tone settings. Pulse rates and volume apply at once; new frequencies are rendered in the background
+// and swapped in by the flight loop, and until then the old tones keep playing.
+static void ApplyToneSettings(const ToneSettings& settings) {
+    if (!isValidToneSettings(settings)) {
+        LOG_WARNING("Tone settings not changed: tones must be %.0f to %.0f Hz, pulse rates must increase up to "
+                    "%.0f per second and volume must be 0 to 1", TONE_FREQUENCY_MIN, TONE_FREQUENCY_MAX,
+                    TONE_PULSE_RATE_MAX);
+        UpdateToneTextFields();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(toneMutex);
+        toneSettings = settings;
+    }
+    if (context) {
+        AL_CHECKED(alSourcef(audioSource, AL_GAIN, settings.volume));
+        if (settings.normalFrequency != toneRequestedNormal || settings.highFrequency != toneRequestedHigh) {
+            toneRenderer.request(settings.normalFrequency, settings.highFrequency);
+            toneRequestedNormal = settings.normalFrequency;
+            toneRequestedHigh = settings.highFrequency;
+        }
+    }
+    UpdateToneTextFields();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Switch the tone to another AOA dataref. The filter restarts from the new source so the spike filter
+// doesn't reject the offset between sources.
+static void SelectAoaSource(int index) {
+    aoaSourceIndex = index;
+    aoaFilter.reset(flightData.aoaSources[index]);
+
+    char text[50];
+    snprintf(text, sizeof(text), "AOA Source: %s", AOA_SOURCES[index].label);
+    if (widgetButtonAoaSource) {
+        XPSetWidgetDescriptor(widgetButtonAoaSource, text);
+    }
+
+    LOG_INFO("AOA source set to %s", AOA_SOURCES[index].dataRef);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Cycle to the next AOA source this aircraft actually publishes
+static void SelectNextAoaSource() {
+    for (int i = 1; i <= AOA_SOURCE_COUNT; i++) {
+        int index = (aoaSourceIndex + i) % AOA_SOURCE_COUNT;
+        if (flightDataSet.isResolved(index)) {
+            SelectAoaSource(index);
+            return;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hand the recorded segment to the analyzer thread; ReportAoaCharacterization logs the result when it is in
+static void FinishAoaCharacterization() {
+    char path[512];
+    XPLMGetSystemPath(path);
+    snprintf(path + strlen(path), sizeof(path) - strlen(path), "Output%sFlyOnSpeed_aoa_sources.csv", XPLMGetDirectorySeparator());
+
+    // alpha is the flight model's own value, so the other sources are measured against it
+    int frames = aoaCharacterizer.frameCount();
+    if (aoaAnalyzer.requestAnalysis(aoaCharacterizer, 0, path)) {
+        LOG_INFO("Analyzing %d frames of AOA sources", frames);
+        if (widgetButtonCharacterize) {
+            XPSetWidgetDescriptor(widgetButtonCharacterize, "Characterize: Analyzing");
+        }
+        return;
+    }
+
+    LOG_WARNING("Still analyzing the last AOA source segment, dropping this one");
+    if (widgetButtonCharacterize) {
+        XPSetWidgetDescriptor(widgetButtonCharacterize, "Characterize: Start");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Report how every AOA source compared over the segment
+static void ReportAoaCharacterization(const AoaSourceAnalysis& analysis) {
+    for (int i = 0; i < AOA_SOURCE_COUNT; i++) {
+        const AoaSourceReport& report = analysis.reports[i];
+        if (!flightDataSet.isResolved(i)) {
+            LOG_INFO("AOA source %s: not available", AOA_SOURCES[i].label);
+        } else {
+            LOG_INFO("AOA source %s: %d frames, lag %.0f frames (%.1f ms), correlation %.3f, noise variance %.6f deg^2",
+                     AOA_SOURCES[i].label, report.samples, report.lagFrames, report.lagMs, report.correlation,
+                     report.noiseVariance);
+        }
+    }
+
+    if (analysis.csvWritten) {
+        LOG_INFO("AOA source log written to %s", analysis.csvPath);
+    } else {
+        LOG_ERROR("Failed to write AOA source log %s", analysis.csvPath);
+    }
+
+    // Unless a new segment was started while this one was analyzed
+    if (widgetButtonCharacterize && !aoaCharacterizer.isRunning()) {
+        XPSetWidgetDescriptor(widgetButtonCharacterize, "Characterize: Start");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Start or stop logging every AOA source side by side
+static void ToggleAoaCharacterization() {
+    if (aoaCharacterizer.isRunning()) {
+        aoaCharacterizer.stop();
+        FinishAoaCharacterization();
+        return;
+    }
+
+    LOG_INFO("Characterizing AOA sources");
+    aoaCharacterizer.start();
+    if (widgetButtonCharacterize) {
+        XPSetWidgetDescriptor(widgetButtonCharacterize, "Characterize: Stop");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Report the calibrated setpoints and put them in the text fields. They take effect on Update Values, so the
+// pilot can look them over first.
+static void FinishAoaCalibration() {
+    if (widgetButtonCalibrate) {
+        XPSetWidgetDescriptor(widgetButtonCalibrate, "Calibrate: Start");
+    }
+    if (!aoaCalibration.hasResult()) {
+        LOG_WARNING("Calibration failed: %s", aoaCalibration.failure());
+        return;
+    }
+
+    const CalibrationResult& result = aoaCalibration.result();
+    LOG_INFO("Calibration: %lld frames, flaps %.2f, AOA = %.2f + %.3f * G * (100 / IAS)^2, r^2 %.3f, "
+             "stall %.1f deg at %.0f kt",
+             result.samples, result.flapRatio, result.zeroLiftAoa, result.slope, result.rSquared,
+             result.stallAoa, result.stallIas);
+    LOG_INFO("Proposed setpoints - Below LDMax: %.1f, Below OnSpeed: %.1f, OnSpeed Max: %.1f, Above OnSpeed: %.1f",
+             result.proposed.belowLDMax, result.proposed.belowOnSpeed, result.proposed.onSpeedMax,
+             result.proposed.aboveOnSpeedMax);
+
+    temp_AOA_BELOW_LDMAX = result.proposed.belowLDMax;
+    temp_AOA_BELOW_ONSPEED = result.proposed.belowOnSpeed;
+    temp_AOA_ONSPEED_MAX = result.proposed.onSpeedMax;
+    temp_AOA_ABOVE_ONSPEED_MAX = result.proposed.aboveOnSpeedMax;
+    if (audioControlWidget) {
+        const XPWidgetID fields[] = {widgetAOABelowLDMax, widgetAOABelowOnSpeed, widgetAOAOnSpeedMax,
+                                     widgetAOAAboveOnSpeedMax};
+        const float values[] = {temp_AOA_BELOW_LDMAX, temp_AOA_BELOW_ONSPEED, temp_AOA_ONSPEED_MAX,
+                                temp_AOA_ABOVE_ONSPEED_MAX};
+        char buffer[16];
+        for (int i = 0; i < 4; i++) {
+            snprintf(buffer, sizeof(buffer), "%.1f", values[i]);
+            XPSetWidgetDescriptor(fields[i], buffer);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Start watching for a deceleration to the stall, or end the run early
+static void ToggleAoaCalibration() {
+    if (aoaCalibration.isRunning()) {
+        aoaCalibration.stop();
+        FinishAoaCalibration();
+        return;
+    }
+
+    LOG_INFO("Calibrating: hold the flaps still and slow down 1 kt/s to the stall");
+    aoaCalibration.start(currentThresholds());
+    if (widgetButtonCalibrate) {
+        XPSetWidgetDescriptor(widgetButtonCalibrate, "Calibrate: Stop");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Ask the profile store for the user aircraft's profile. The file is read on the store's thread and applied
+// by the flight loop once it is in.
+static void RequestAircraftProfile() {
+    char fileName[256];
+    char acfPath[512];
+    XPLMGetNthAircraftModel(XPLM_USER_AIRCRAFT, fileName, acfPath);
+    if (!fileName[0]) {
+        return;     // no aircraft loaded yet
+    }
+
+    snprintf(profileAircraft, sizeof(profileAircraft), "%.*s", AIRCRAFT_NAME_MAX - 1, fileName);
+    char name[AIRCRAFT_NAME_MAX];
+    snprintf(name, sizeof(name), "%s", profileAircraft);
+    char* extension = strrchr(name, '.');
+    if (extension && !strcmp(extension, ".acf")) {
+        *extension = '\0';
+    }
+
+    const char* separator = XPLMGetDirectorySeparator();
+    XPLMGetSystemPath(profilePath);
+    snprintf(profilePath + strlen(profilePath), sizeof(profilePath) - strlen(profilePath),
+             "Output%spreferences%sFlyOnSpeed%s%s.profile", separator, separator, separator, name);
+    profileStore.requestLoad(profilePath, profileAircraft);
+    profileHotReload = false;
+    profileWatcher.watch(profilePath);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Output/preferences/FlyOnSpeed_warm_state.bin
+static void GetWarmStatePath(char* path, size_t size) {
+    const char* separator = XPLMGetDirectorySeparator();
+    XPLMGetSystemPath(path);
+    snprintf(path + strlen(path), size - strlen(path), "Output%spreferences%sFlyOnSpeed_warm_state.bin",
+             separator, separator);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Snapshot the filter, zone and config, for RestoreWarmState after a plugin reload
+static void SaveWarmState() {
+    WarmState state;
+    initWarmState(state);
+    char fileName[256];
+    char acfPath[512];
+    XPLMGetNthAircraftModel(XPLM_USER_AIRCRAFT, fileName, acfPath);
+    snprintf(state.aircraft, sizeof(state.aircraft), "%.*s", AIRCRAFT_NAME_MAX - 1, fileName);
+    aoaFilter.saveState(state.filter);
+    state.zone = static_cast<int32_t>(lastToneZone);
+    state.thresholds = currentThresholds();
+    state.tone = toneSettings;
+    state.aoaSourceIndex = aoaSourceIndex;
+    state.audioEnabled = audioEnabled ? 1 : 0;
+
+    char path[512];
+    GetWarmStatePath(path, sizeof(path));
+    if (!writeWarmState(path, state)) {
+        LOG_WARNING("Failed to write %s", path);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Carry on from the snapshot SaveWarmState wrote, if it is recent and for this aircraft. The filter history is
+// only taken if the live AOA is still within spike range of it; otherwise, or with no snapshot, the filter
+// starts from the live AOA rather than 0°, which the spike filter would hold on to.
+static void RestoreWarmState() {
+    flightDataSet.read(flightData);
+
+    char path[512];
+    GetWarmStatePath(path, sizeof(path));
+    WarmState state;
+    char error[64];
+    char fileName[256];
+    char acfPath[512];
+    XPLMGetNthAircraftModel(XPLM_USER_AIRCRAFT, fileName, acfPath);
+    if (!readWarmState(path, state, error, sizeof(error))) {
+        LOG_DEBUG("Not restoring warm state: %s", error);
+    } else if (warmStateAge(state) < 0 || warmStateAge(state) > WARM_STATE_MAX_AGE_SECONDS) {
+        LOG_INFO("Warm state is %lld s old, starting fresh", static_cast<long long>(warmStateAge(state)));
+    } else if (strncmp(state.aircraft, fileName, AIRCRAFT_NAME_MAX - 1) != 0) {
+        LOG_INFO("Warm state is for %s, starting fresh", state.aircraft);
+    } else {
+        PublishThresholds(state.thresholds);
+        ApplyToneSettings(state.tone);
+        snprintf(warmStateAircraft, sizeof(warmStateAircraft), "%s", state.aircraft);
+        audioEnabled = state.audioEnabled != 0;
+        if (audioToggleCheckbox) {
+            XPSetWidgetDescriptor(audioToggleCheckbox, audioEnabled ? "Sound: On" : "Sound: Off");
+        }
+        if (state.aoaSourceIndex != aoaSourceIndex && state.aoaSourceIndex >= 0 &&
+            state.aoaSourceIndex < AOA_SOURCE_COUNT && flightDataSet.isResolved(state.aoaSourceIndex)) {
+            SelectAoaSource(state.aoaSourceIndex);
+        }
+
+        float liveAoa = flightData.aoaSources[aoaSourceIndex];
+        if (std::abs(liveAoa - state.filter.lastValidAoa) <= aoaFilter.spikeLimit() &&
+            aoaFilter.restoreState(state.filter)) {
+            if (state.zone >= static_cast<int32_t>(ToneZone::BelowIAS) &&
+                state.zone <= static_cast<int32_t>(ToneZone::Stall)) {
+                lastToneZone = static_cast<ToneZone>(state.zone);
+            }
+            currentAOA = aoaFilter.average();
+            LOG_INFO("Restored warm state from %lld s ago, AOA %.1f", static_cast<long long>(warmStateAge(state)),
+                     aoaFilter.average());
+            return;
+        }
+        LOG_INFO("Restored warm state settings, AOA has moved on to %.1f", liveAoa);
+        aoaFilter.setWindow(state.filter.window);
+    }
+
+    aoaFilter.reset(flightData.aoaSources[aoaSourceIndex]);
+    currentAOA = aoaFilter.average();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Switch to a loaded profile. An aircraft with no profile, or a bad one, gets the compiled in defaults
+// rather than keeping the last aircraft's setpoints.
+static void ApplyAircraftProfile(const ProfileLoad& load) {
+    // The load XPluginEnable asks for after a plugin reload: the warm state already has this aircraft's
+    // setpoints, tone and filter as they were, edits not yet in the file included
+    if (!profileHotReload && warmStateAircraft[0]) {
+        bool restored = !strcmp(load.profile.aircraft, warmStateAircraft);
+        warmStateAircraft[0] = '\0';
+        if (restored) {
+            LOG_INFO("Keeping the warm state setpoints over %s", load.path);
+            const AoaThresholds current = currentThresholds();
+            temp_AOA_BELOW_LDMAX = current.belowLDMax;
+            temp_AOA_BELOW_ONSPEED = current.belowOnSpeed;
+            temp_AOA_ONSPEED_MAX = current.onSpeedMax;
+            temp_AOA_ABOVE_ONSPEED_MAX = current.aboveOnSpeedMax;
+            temp_AOA_IAS_TONE_ENABLE = current.iasToneEnable;
+            UpdateAOATextFields();
+            uiPresenter.invalidate();
+            return;
+        }
+    }
+
+    // An edit that doesn't parse, or a half written file, mustn't throw away working setpoints in flight
+    if (profileHotReload) {
+        if (load.status != ProfileLoadStatus::Loaded) {
+            LOG_WARNING("Keeping the current setpoints, %s: %s", load.path,
+                        load.status == ProfileLoadStatus::Missing ? "file removed" : load.error);
+            return;
+        }
+        const AoaThresholds current = currentThresholds();
+        const AoaThresholds& t = load.profile.thresholds;
+        if (t.belowLDMax == current.belowLDMax && t.belowOnSpeed == current.belowOnSpeed &&
+            t.onSpeedMax == current.onSpeedMax && t.aboveOnSpeedMax == current.aboveOnSpeedMax &&
+            t.iasToneEnable == current.iasToneEnable && load.profile.filterWindow == aoaFilter.window() &&
+            !memcmp(&load.profile.tone, &toneSettings, sizeof(ToneSettings))) {
+            return;     // our own save coming back round
+        }
+    }
+
+    if (load.status == ProfileLoadStatus::Loaded) {
+        LOG_INFO("Loaded aircraft profile %s", load.path);
+    } else if (load.status == ProfileLoadStatus::Invalid) {
+        LOG_WARNING("Ignoring aircraft profile %s: %s, using defaults", load.path, load.error);
+    } else {
+        LOG_INFO("No profile for %s, using defaults", load.profile.aircraft);
+    }
+
+    const AoaThresholds& t = load.profile.thresholds;
+    PublishThresholds(t);
+    if (load.profile.filterWindow != aoaFilter.window()) {
+        aoaFilter.setWindow(load.profile.filterWindow);
+        aoaFilter.reset(flightData.aoaSources[aoaSourceIndex]);
+    }
+    ApplyToneSettings(load.profile.tone);
+
+    temp_AOA_BELOW_LDMAX = t.belowLDMax;
+    temp_AOA_BELOW_ONSPEED = t.belowOnSpeed;
+    temp_AOA_ONSPEED_MAX = t.onSpeedMax;
+    temp_AOA_ABOVE_ONSPEED_MAX = t.aboveOnSpeedMax;
+    temp_AOA_IAS_TONE_ENABLE = t.iasToneEnable;
+    UpdateAOATextFields();
+    uiPresenter.invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Write the current setpoints to the user aircraft's profile, in the background
+static void SaveAircraftProfile() {
+    if (!profilePath[0]) {
+        return;
+    }
+
+    AircraftProfile profile;
+    snprintf(profile.aircraft, sizeof(profile.aircraft), "%s", profileAircraft);
+    profile.thresholds = currentThresholds();
+    profile.filterWindow = aoaFilter.window();
+    profile.tone = toneSettings;
+    if (!isValidAircraftProfile(profile)) {
+        LOG_WARNING("Not saving the profile for %s: setpoints must increase from Below LDMax to Above OnSpeed",
+                    profileAircraft);
+        return;
+    }
+    profileStore.requestSave(profilePath, profile);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Start recording spans, or stop and write them to Output/FlyOnSpeed_trace.json for Perfetto or chrome://tracing
+static void ToggleTrace() {
+    TraceRecorder& trace = pluginTrace();
+    if (!trace.isRunning()) {
+        trace.start();
+        LOG_INFO("Tracing started");
+        return;
+    }
+
+    trace.stop();
+    char path[512];
+    XPLMGetSystemPath(path);
+    snprintf(path + strlen(path), sizeof(path) - strlen(path), "Output%sFlyOnSpeed_trace.json", XPLMGetDirectorySeparator());
+    if (trace.writeJson(path)) {
+        LOG_INFO("Trace written to %s (%lld spans dropped)", path, trace.dropped());
+    } else {
+        LOG_ERROR("Failed to write trace %s", path);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Start recording every frame to Output/FlyOnSpeed_<date>_<time>.fosrec, or stop and close the file
+static void ToggleRecording() {
+    if (flightRecorder.isOpen()) {
+        flightRecorder.close();
+        LOG_INFO("Recorded %llu frames to %s (%llu dropped)", static_cast<unsigned long long>(flightRecorder.count()),
+                 flightRecorder.path(), static_cast<unsigned long long>(flightRecorder.dropped()));
+        return;
+    }
+
+    char stamp[32];
+    time_t now = time(nullptr);
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+
+    char path[512];
+    XPLMGetSystemPath(path);
+    snprintf(path + strlen(path), sizeof(path) - strlen(path), "Output%sFlyOnSpeed_%s.fosrec",
+             XPLMGetDirectorySeparator(), stamp);
+    recordingTime = 0.0;
+    if (flightRecorder.open(path)) {
+        LOG_INFO("Recording to %s", path);
+    } else {
+        LOG_ERROR("Failed to create recording %s", path);
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -557,24 +1291,57 @@ static void AudioMenuHandler(void * mRef, void * iRef)
 {
     if (!strcmp((char *)iRef, "Show")) {
         if (!audioControlWidget) {
-            CreateAudioControlWindow(300, 600, 250, 350);
+            CreateAudioControlWindow(300, 800, 250, 645);
         } else if (!XPIsWidgetVisible(audioControlWidget)) {
             XPShowWidget(audioControlWidget);
             UpdateAOATextFields(); // Update text fields when showing the window
+            uiPresenter.invalidate();
+        }
+    } else if (!strcmp((char *)iRef, "Tape")) {
+        if (!tapeWindow.exists()) {
+            tapeWindow.create(560, 800, 800, 560);
+        } else {
+            tapeWindow.setVisible(!tapeWindow.isVisible());
         }
+    } else if (!strcmp((char *)iRef, "Scope")) {
+        if (!scopeWindow.exists()) {
+            scopeWindow.create(820, 800, 1320, 560);
+        } else {
+            scopeWindow.setVisible(!scopeWindow.isVisible());
+        }
+    } else if (!strcmp((char *)iRef, "Trace")) {
+        ToggleTrace();
+    } else if (!strcmp((char *)iRef, "Record")) {
+        ToggleRecording();
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Sleep between pulses, returning early as soon as the thread is asked to stop.
+// A plain sleep_for could hold up XPluginStop for a whole pulse period, about 670 ms at the slowest rate.
+static void PulseSleep(int ms) {
+    std::unique_lock<std::mutex> lock(pulseWakeMutex);
+    pulseWake.wait_for(lock, std::chrono::milliseconds(ms), [] { return !threadRunning; });
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Modify the PulseThreadFunction to handle variable pulse rates
 void PulseThreadFunction() {
-    float lastFrequency = 0.0f;
+    pluginTrace().registerThread("pulse");
+    int thresholdReader = thresholdCell.registerReader();
+    if (thresholdReader < 0) {
+        LOG_ERROR("No threshold reader slot left for the pulse thread");
+        return;
+    }
 
     while (threadRunning) {
+        // Not holding a threshold snapshot from the last pass any more
+        thresholdCell.quiescent(thresholdReader);
 
         if (!audioEnabled || !shouldPlay) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            PulseSleep(50);
             continue;
         }
 
@@ -585,86 +1352,139 @@ void PulseThreadFunction() {
             localAOA = currentAOA;
         }
 
-        // Determine pulse rate and frequency based on AOA
-        if (localAOA > AOA_ABOVE_ONSPEED_MAX) {
-            audioPulseRate = PULSE_RATE_STALL;
-            audioFrequency = TONE_HIGH_FREQ;
-        } else if (localAOA > AOA_ONSPEED_MAX) {
-            // Calculate variable pulse rate for Above OnSpeed condition
-            float t = (localAOA - AOA_ONSPEED_MAX) / (AOA_ABOVE_ONSPEED_MAX - AOA_ONSPEED_MAX);
-            audioPulseRate = ABOVE_ONSPEED_PULSE_MIN + t * (ABOVE_ONSPEED_PULSE_MAX - ABOVE_ONSPEED_PULSE_MIN);
-            audioFrequency = TONE_HIGH_FREQ;
-        } else if (localAOA >= AOA_BELOW_LDMAX && localAOA <= AOA_BELOW_ONSPEED) {
-            float t = (localAOA - AOA_BELOW_LDMAX) / (AOA_BELOW_ONSPEED - AOA_BELOW_LDMAX);
-            audioPulseRate = PULSE_RATE_MIN + t * (PULSE_RATE_MAX - PULSE_RATE_MIN);
-            audioFrequency = TONE_NORMAL_FREQ;
-        }
-
-        // If frequency changed, switch buffers
-        if (lastFrequency != audioFrequency) {
-            lastFrequency = audioFrequency;
-            alSourceStop(audioSource);
-            if (audioFrequency == TONE_HIGH_FREQ) {
-                alSourcei(audioSource, AL_BUFFER, audioBufferHigh);
-            } else {
-                alSourcei(audioSource, AL_BUFFER, audioBufferNormal);
+        // The next pulse is due sleepMs after this one starts, anything the AL calls block for makes it late
+        auto pulseStart = std::chrono::steady_clock::now();
+        int sleepMs;
+
+        {
+            TRACE_SPAN("pulse");
+            std::unique_lock<std::mutex> toneLock(toneMutex);
+
+            // Determine pulse rate and frequency based on AOA
+            ToneState tone = computeToneState(localAOA, *thresholdCell.read(), toneSettings);
+            if (!isPulsingZone(tone.zone)) {
+                // The flight loop hasn't caught up with a zone change yet
+                toneLock.unlock();
+                PulseSleep(50);
+                continue;
             }
-        }
 
-        // Calculate sleep duration based on pulse rate
-        int sleepMs = static_cast<int>(1000.0f / audioPulseRate);
+            // Calculate sleep duration based on pulse rate
+            sleepMs = static_cast<int>(1000.0f / tone.pulseRate);
+
+            // Switch buffers if the zone's tone isn't the one attached: a zone change, the steady tone having
+            // taken over, or newly rendered buffers
+            ALuint buffer = isHighToneZone(tone.zone) ? toneBuffers.high : toneBuffers.normal;
+            ALint attached = 0;
+            AL_CHECKED(alGetSourcei(audioSource, AL_BUFFER, &attached));
+            if (static_cast<ALuint>(attached) != buffer) {
+                TRACE_SPAN("buffer switch");
+                AL_CHECKED(alSourceStop(audioSource));
+                AL_CHECKED(alSourcei(audioSource, AL_BUFFER, buffer));
+                metrics.increment(metricBufferSwitches);
+            }
+            toneLock.unlock();
+
+            AL_CHECKED(alSourcei(audioSource, AL_LOOPING, AL_FALSE));
+            AL_CHECKED(alSourcePlay(audioSource));
+            metrics.increment(metricPulses);
+        }
 
-        alSourcei(audioSource, AL_LOOPING, AL_FALSE);
-        alSourcePlay(audioSource);
+        PulseSleep(sleepMs);
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
+        if (threadRunning) {
+            float lateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - pulseStart).count()
+                           - sleepMs;
+            metrics.set(metricPulseLateMs, lateMs);
+            if (lateMs > PULSE_LATE_MS) {
+                metrics.increment(metricLatePulses);
+            }
+        }
     }
+
+    thresholdCell.unregisterReader(thresholdReader);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Modify PlayAOATone to handle the Below OnSpeed condition
+// Runs every frame on the sim thread. Nothing in here may allocate: the filter is a fixed ring and
+// the presenter formats into fixed buffers.
 void PlayAOATone(float aoa, float elapsedTime) {
-    // Spike filter - if change is too large, use last valid value
-    if (std::abs(aoa - lastValidAoa) > MAX_AOA_CHANGE) {
-        aoa = lastValidAoa;
-    } else {
-        lastValidAoa = aoa;
+    float rawAoa = aoa;
+
+    float avgAoa;
+    {
+        TRACE_SPAN("filter");
+        avgAoa = aoaFilter.update(aoa);
+        aoa = aoaFilter.lastSample();
+        if (aoaFilter.lastWasSpike()) {
+            metrics.increment(metricSpikesRejected);
+        }
     }
 
-    // Update moving average
-    if (aoaHistory.size() >= AOA_HISTORY_SIZE) {
-        aoaHistory.erase(aoaHistory.begin());
+    float ias = flightData.ias;
+
+    AoaThresholds thresholds = currentThresholds();
+    ToneState tone;
+    bool zoneChanged;
+    {
+        TRACE_SPAN("zone");
+        tone = computeToneState(avgAoa, ias, thresholds, toneSettings);
+        zoneChanged = tone.zone != lastToneZone;
+        if (zoneChanged) {
+            metrics.increment(metricZoneTransitions);
+            lastToneZone = tone.zone;
+        }
     }
-    aoaHistory.push_back(aoa);
 
-    // Calculate moving average
-    float avgAoa = 0.0f;
-    for (float value : aoaHistory) {
-        avgAoa += value;
+    if (flightRecorder.isOpen()) {
+        recordingTime += elapsedTime;
+        FlightRecord record = {recordingTime, rawAoa, avgAoa, ias, flightData.gLoad, flightData.flapRatio,
+                               tone.pulseRate, tone.frequency, static_cast<uint8_t>(tone.zone),
+                               static_cast<uint8_t>((aoaFilter.lastWasSpike() ? FLIGHT_RECORD_SPIKE : 0) |
+                                                    (audioEnabled ? FLIGHT_RECORD_AUDIO_ENABLED : 0)),
+                               0};
+        flightRecorder.append(record);
     }
-    avgAoa /= aoaHistory.size();
 
-    float ias = XPLMGetDataf(iasDataRef);
+    // Pulses are started by the pulse thread, so an onset is marked on the first frame that sees the count move
+    {
+        int pulses = metrics.count(metricPulses);
+        scopeTime += elapsedTime;
+        ScopeSample sample = {scopeTime, rawAoa, avgAoa, static_cast<uint8_t>(tone.zone),
+                              static_cast<uint8_t>((pulses != scopePulsesSeen ? SCOPE_PULSE_ONSET : 0) |
+                                                   (aoaFilter.lastWasSpike() ? SCOPE_SPIKE : 0))};
+        scopePulsesSeen = pulses;
+        scopeBuffer.push(sample);
+        scopeWindow.setThresholds(thresholds);
+    }
 
-    // Update widgetAOAValue with both current and averaged AOA values
-    char aoaText[50];
-    snprintf(aoaText, sizeof(aoaText), "AOA: %.1f (avg: %.1f) IAS: %.1f", aoa, avgAoa, ias);
-    XPSetWidgetDescriptor(widgetAOAValue, aoaText);
+    publishedAoaFiltered.store(avgAoa, std::memory_order_relaxed);
+    publishedToneZone.store(static_cast<int>(tone.zone), std::memory_order_relaxed);
+    publishedPulseRate.store(tone.pulseRate, std::memory_order_relaxed);
+    publishedFrequency.store(tone.frequency, std::memory_order_relaxed);
 
+    // Show current and averaged AOA values and what the audio is doing
+    {
+        TRACE_SPAN("ui");
+        LiveFrame frame = {aoa, avgAoa, ias, audioEnabled, tone, frameCost.summary()};
+        tapeWindow.update(frame, thresholds);
+        uiPresenter.update(elapsedTime, frame, thresholds, tapeWindow.isVisible());
+    }
 
     if (!audioEnabled) {
+        TRACE_SPAN("AL stop");
         shouldPlay = false;
-        alSourceStop(audioSource);
-        XPSetWidgetDescriptor(widgetAudioStatus, "");
+        AL_CHECKED(alSourceStop(audioSource));
         return;
     }
 
     // Check if IAS is above the threshold
-    if (ias < AOA_IAS_TONE_ENABLE) {
+    if (tone.zone == ToneZone::BelowIAS) {
+        TRACE_SPAN("AL stop");
         shouldPlay = false;
-        alSourceStop(audioSource);
-        XPSetWidgetDescriptor(widgetAudioStatus, ("Audio: None - Below IAS " + std::to_string(AOA_IAS_TONE_ENABLE)).c_str());
+        AL_CHECKED(alSourceStop(audioSource));
         return;
     }
 
@@ -674,30 +1494,59 @@ void PlayAOATone(float aoa, float elapsedTime) {
         currentAOA = avgAoa;
     }
 
-    if (avgAoa < AOA_BELOW_LDMAX) {
+    if (tone.zone == ToneZone::BelowLDMax) {
+        TRACE_SPAN("AL stop");
         shouldPlay = false;
-        alSourceStop(audioSource);
-        XPSetWidgetDescriptor(widgetAudioStatus, ("Audio: None - Below L/DMax " + std::to_string(AOA_BELOW_LDMAX)).c_str());
+        AL_CHECKED(alSourceStop(audioSource));
         return;
     }
     
     // Handle steady tone for OnSpeed condition
-    if (avgAoa >= AOA_BELOW_ONSPEED && avgAoa <= AOA_ONSPEED_MAX) {
+    if (tone.zone == ToneZone::OnSpeed) {
+        TRACE_SPAN("AL steady tone");
         shouldPlay = false;  // Disable pulsing
-        alSourcef(audioSource, AL_FREQUENCY, TONE_NORMAL_FREQ);
-        alSourcei(audioSource, AL_LOOPING, AL_TRUE);
+        ALint attached = 0;
+        AL_CHECKED(alGetSourcei(audioSource, AL_BUFFER, &attached));
+        if (static_cast<ALuint>(attached) != toneBuffers.normal) {
+            // Coming down from Above OnSpeed, or new buffers. Hold toneMutex so a pulse can't switch it back.
+            std::lock_guard<std::mutex> lock(toneMutex);
+            AL_CHECKED(alSourceStop(audioSource));
+            AL_CHECKED(alSourcei(audioSource, AL_BUFFER, toneBuffers.normal));
+        }
+        AL_CHECKED(alSourcei(audioSource, AL_LOOPING, AL_TRUE));
         ALint state;
-        alGetSourcei(audioSource, AL_SOURCE_STATE, &state);
+        AL_CHECKED(alGetSourcei(audioSource, AL_SOURCE_STATE, &state));
         if (state != AL_PLAYING) {
-            alSourcePlay(audioSource);
+            AL_CHECKED(alSourcePlay(audioSource));
         }
-        XPSetWidgetDescriptor(widgetAudioStatus, "Audio: Steady - OnSpeed");
     } else {
         shouldPlay = true;  // Enable pulsing for all other conditions
+    }
+}
 
-        char audioStatusText[50];
-        snprintf(audioStatusText, sizeof(audioStatusText), "Audio Hz: %.1f pps: %.1f", audioFrequency, audioPulseRate);
-        XPSetWidgetDescriptor(widgetAudioStatus, audioStatusText);
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Put newly rendered tone buffers in place and delete old ones the source has let go of.
+// From here on the pulse thread can only pick up the new buffers, see toneMutex.
+static void SwapToneBuffers() {
+    ToneBuffers rendered;
+    if (toneRenderer.take(rendered)) {
+        ToneBuffers old = toneBuffers;
+        {
+            std::lock_guard<std::mutex> lock(toneMutex);
+            toneBuffers = rendered;
+        }
+        // Once swapped, the pulse thread can only attach the new buffers, so this can only move off the old ones
+        ALint attached = 0;
+        AL_CHECKED(alGetSourcei(audioSource, AL_BUFFER, &attached));
+        toneRenderer.retire(old, static_cast<ALuint>(attached));
+        LOG_INFO("Tones now %.0f / %.0f Hz", rendered.normalFrequency, rendered.highFrequency);
+    }
+
+    if (toneRenderer.hasRetired()) {
+        ALint attached = 0;
+        AL_CHECKED(alGetSourcei(audioSource, AL_BUFFER, &attached));
+        toneRenderer.collectRetired(static_cast<ALuint>(attached));
     }
 }
 
@@ -708,18 +1557,79 @@ float CheckAOAAndPlayTone(float inElapsedSinceLastCall,
                          float inElapsedTimeSinceLastFlightLoop, 
                          int inCounter, 
                          void *inRefcon) {
+    auto frameStart = std::chrono::steady_clock::now();
+    TRACE_SPAN("flight loop");
+
+    // Read all the datarefs in one pass.  https://developer.x-plane.com/sdk/XPLMDataAccess/#XPLMDataRef
+    {
+        TRACE_SPAN("read datarefs");
+        flightDataSet.read(flightData);
+    }
+    metrics.increment(metricFrames);
+
+    ProfileLoad profileLoad;
+    if (profileStore.takeLoaded(profileLoad)) {
+        ApplyAircraftProfile(profileLoad);
+    }
+    AoaSourceAnalysis sourceAnalysis;
+    if (aoaAnalyzer.takeResult(sourceAnalysis)) {
+        ReportAoaCharacterization(sourceAnalysis);
+    }
+    if (profileWatcher.takeChanged()) {
+        profileHotReload = true;
+        profileStore.requestLoad(profilePath, profileAircraft);
+    }
+    if (context) {
+        SwapToneBuffers();
+    }
+    if (thresholdCell.retiredCount()) {
+        thresholdCell.reclaim();     // old thresholds the pulse thread has moved past
+    }
 
-    // use XPLMGetDataf to get the AOA value.  https://developer.x-plane.com/sdk/XPLMDataAccess/#XPLMDataRef
+    if (aoaCharacterizer.isRunning()) {
+        aoaCharacterizer.addFrame(inElapsedSinceLastCall, flightData.aoaSources);
+        if (!aoaCharacterizer.isRunning()) {
+            FinishAoaCharacterization();    // segment is full
+        }
+    }
+
+    PlayAOATone(flightData.aoaSources[aoaSourceIndex], inElapsedSinceLastCall);
+
+    if (aoaCalibration.isRunning()) {
+        float gLoad = flightDataSet.isResolved(FLIGHT_DATA_G_LOAD) ? flightData.gLoad : 1.0f;
+        if (aoaCalibration.addFrame(aoaFilter.lastSample(), flightData.ias, gLoad, flightData.flapRatio)) {
+            FinishAoaCalibration();     // stall break seen
+        }
+    }
 
-    float aoa = XPLMGetDataf(aoaDataRef);
-    PlayAOATone(aoa, inElapsedSinceLastCall);
+    // Everything above counts against the frame budget, including time spent waiting on the AL driver
+    int64_t frameNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - frameStart).count();
+    if (frameCost.add(frameNs, inElapsedSinceLastCall)) {
+        const FrameCostSummary& cost = frameCost.summary();
+        publishedFrameCostMin.store(cost.minUs, std::memory_order_relaxed);
+        publishedFrameCostMean.store(cost.meanUs, std::memory_order_relaxed);
+        publishedFrameCostP99.store(cost.p99Us, std::memory_order_relaxed);
+        publishedFrameCostMax.store(cost.maxUs, std::memory_order_relaxed);
+        publishedFramesOverBudget.store(static_cast<int>(cost.overBudget), std::memory_order_relaxed);
+    }
     return -1.0f;  // Negative value means "call me next frame"
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hand the queued log messages to XPLMDebugString, which may only be called from the sim thread
+static float FlushLog(float elapsed, float elapsedSim, int counter, void* refcon) {
+    pluginLog().flush();
+    return LOG_FLUSH_INTERVAL_MS / 1000.0f;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Modified XPluginStart to register a flight loop for updating text fields
 PLUGIN_API int XPluginStart(char *outName, char *outSig, char *outDesc) {
+    PhaseTimer timer("XPluginStart");
+
     strcpy(outName, "AOA-Tone-FlyOnSpeed");
     strcpy(outSig, "xplane.plugin.aoa-tone-flyon-speed");
     strcpy(outDesc, "A plugin that plays audio tones based on AOA");
@@ -731,6 +1641,12 @@ PLUGIN_API int XPluginStart(char *outName, char *outSig, char *outDesc) {
 		return 0;
 	}
 
+    // Everything we log from here on is queued, and written to Log.txt in batches by FlushLog
+    pluginLog().start(XPLMDebugString, "FlyOnSpeed: ");
+    XPLMRegisterFlightLoopCallback(FlushLog, LOG_FLUSH_INTERVAL_MS / 1000.0f, nullptr);
+    pluginTrace().registerThread("sim");
+    alCheckSetErrorHandler(CountAlError);
+
     // if (!initializeAudio()) {
     //     XPLMDebugString("Failed to initialize audio");
     //     return 0;
@@ -739,35 +1655,53 @@ PLUGIN_API int XPluginStart(char *outName, char *outSig, char *outDesc) {
 	XPLMRegisterFlightLoopCallback(init_sound,-1.0,NULL);	
 
 
-    // find the AOA DataRef 
+    // find the AOA and IAS DataRefs
     // https://developer.x-plane.com/sdk/XPLMDataAccess/#XPLMDataRef
-
-    // here is a site that shows a list of DataRefs:
-    // https://siminnovations.com/xplane/dataref/index.php
-
-    // find the AOA DataRef.
-    // use sim/cockpit2/gauges/indicators/AoA_pilot ??
-    // or sim/cockpit2/gauges/indicators/aoa_angle_degrees ??
-    // sim/flightmodel/position/alpha
-
-    aoaDataRef = XPLMFindDataRef("sim/flightmodel/position/alpha");
-    if (aoaDataRef == nullptr) {
-        XPLMDebugString("FlyOnSpeed: Failed to find AOA DataRef");
+    if (!flightDataSet.resolve()) {
+        XPLMUnregisterFlightLoopCallback(FlushLog, nullptr);
+        XPLMUnregisterFlightLoopCallback(init_sound, nullptr);
+        pluginLog().stop();
         return 0;
     }
-
-    // ias in knots
-    iasDataRef = XPLMFindDataRef("sim/flightmodel/position/indicated_airspeed");
-    if (iasDataRef == nullptr) {
-        XPLMDebugString("FlyOnSpeed: Failed to find IAS DataRef");
-        return 0;
+    timer.mark("datarefs");
+
+    // Ask for XPLM_MSG_DATAREFS_ADDED so datarefs published by other plugins after us get picked up
+    XPLMEnableFeature("XPLM_WANTS_DATAREF_NOTIFICATIONS", 1);
+
+    // Publish what we compute. tone_zone is the ToneZone value: 0 below IAS, 1 below L/DMax,
+    // 2 below OnSpeed, 3 OnSpeed, 4 above OnSpeed, 5 stall warning.
+    publishedDataRefs.addFloat("flyonspeed/aoa_filtered", &publishedAoaFiltered);
+    publishedDataRefs.addInt("flyonspeed/tone_zone", &publishedToneZone);
+    publishedDataRefs.addFloat("flyonspeed/pps", &publishedPulseRate);
+    publishedDataRefs.addFloat("flyonspeed/frequency", &publishedFrequency);
+
+    // Setpoints in effect, in degrees, and the IAS in knots above which the tone plays
+    publishedDataRefs.addFloat("flyonspeed/setpoints/below_ldmax", &publishedBelowLDMax);
+    publishedDataRefs.addFloat("flyonspeed/setpoints/below_onspeed", &publishedBelowOnSpeed);
+    publishedDataRefs.addFloat("flyonspeed/setpoints/onspeed_max", &publishedOnSpeedMax);
+    publishedDataRefs.addFloat("flyonspeed/setpoints/above_onspeed_max", &publishedAboveOnSpeedMax);
+    publishedDataRefs.addFloat("flyonspeed/setpoints/ias_tone_enable", &publishedIasToneEnable);
+
+    // Cost of our flight loop callback over the last FRAME_COST_WINDOW_SECONDS, in microseconds
+    publishedDataRefs.addFloat("flyonspeed/perf/frame_us_min", &publishedFrameCostMin);
+    publishedDataRefs.addFloat("flyonspeed/perf/frame_us_mean", &publishedFrameCostMean);
+    publishedDataRefs.addFloat("flyonspeed/perf/frame_us_p99", &publishedFrameCostP99);
+    publishedDataRefs.addFloat("flyonspeed/perf/frame_us_max", &publishedFrameCostMax);
+    publishedDataRefs.addInt("flyonspeed/perf/frames_over_budget", &publishedFramesOverBudget);
+
+    for (int i = 0; i < metrics.size(); i++) {
+        char name[96];
+        snprintf(name, sizeof(name), "flyonspeed/metrics/%s", metrics.name(i));
+        if (metrics.kind(i) == MetricKind::Counter) {
+            publishedDataRefs.addInt(name, metrics.counterValue(i));
+        } else {
+            publishedDataRefs.addFloat(name, metrics.gaugeValue(i));
+        }
     }
+    timer.mark("published datarefs");
 
-    // aircraftNameDataRef = XPLMFindDataRef("sim/aircraft/view/acf_name");
-    // if (aircraftNameDataRef == nullptr) {
-    //     XPLMDebugString("FlyOnSpeed: Failed to find aircraft name DataRef");
-    //     return 0;
-    // }
+    profileStore.start();
+    aoaAnalyzer.start();
 
     XPLMRegisterFlightLoopCallback(CheckAOAAndPlayTone, 1.0, nullptr);
 
@@ -775,18 +1709,26 @@ PLUGIN_API int XPluginStart(char *outName, char *outSig, char *outDesc) {
     int item = XPLMAppendMenuItem(XPLMFindPluginsMenu(), "Fly On Speed", nullptr, 1);
     menuId = XPLMCreateMenu("Fly On Speed", XPLMFindPluginsMenu(), item, AudioMenuHandler, nullptr);
     XPLMAppendMenuItem(menuId, "Show", (void*)"Show", 1);
+    XPLMAppendMenuItem(menuId, "Toggle AOA Tape", (void*)"Tape", 1);
+    XPLMAppendMenuItem(menuId, "Toggle AOA Scope", (void*)"Scope", 1);
+    XPLMAppendMenuItem(menuId, "Toggle Trace", (void*)"Trace", 1);
+    XPLMAppendMenuItem(menuId, "Toggle Recording", (void*)"Record", 1);
+    timer.mark("flight loop and menu");
 
     // Start the pulse thread
     threadRunning = true;
     pulseThread = new std::thread(PulseThreadFunction);
+    timer.mark("pulse thread");
 
     // Initialize temporary variables
-    temp_AOA_BELOW_LDMAX = AOA_BELOW_LDMAX;
-    temp_AOA_BELOW_ONSPEED = AOA_BELOW_ONSPEED;
-    temp_AOA_ONSPEED_MAX = AOA_ONSPEED_MAX;
-    temp_AOA_ABOVE_ONSPEED_MAX = AOA_ABOVE_ONSPEED_MAX;
-    temp_AOA_IAS_TONE_ENABLE = AOA_IAS_TONE_ENABLE;
-
+    const AoaThresholds thresholds = currentThresholds();
+    temp_AOA_BELOW_LDMAX = thresholds.belowLDMax;
+    temp_AOA_BELOW_ONSPEED = thresholds.belowOnSpeed;
+    temp_AOA_ONSPEED_MAX = thresholds.onSpeedMax;
+    temp_AOA_ABOVE_ONSPEED_MAX = thresholds.aboveOnSpeedMax;
+    temp_AOA_IAS_TONE_ENABLE = thresholds.iasToneEnable;
+
+    LogPhaseTimer(timer);
     return 1;
 }
 
@@ -794,27 +1736,68 @@ PLUGIN_API int XPluginStart(char *outName, char *outSig, char *outDesc) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Modify XPluginStop to cleanup the thread
 PLUGIN_API void XPluginStop(void) {
-    // Stop the pulse thread
-    threadRunning = false;
+    PhaseTimer timer("XPluginStop");
+
+    // Don't lose a trace that is still recording
+    if (pluginTrace().isRunning()) {
+        ToggleTrace();
+        timer.mark("trace");
+    }
+    if (flightRecorder.isOpen()) {
+        ToggleRecording();
+        timer.mark("recording");
+    }
+
+    // Stop the pulse thread, waking it if it is between pulses
+    {
+        std::lock_guard<std::mutex> lock(pulseWakeMutex);
+        threadRunning = false;
+    }
+    pulseWake.notify_all();
     if (pulseThread) {
         pulseThread->join();
         delete pulseThread;
         pulseThread = nullptr;
     }
+    timer.mark("pulse thread");
 
+    uiPresenter.detach();
     if (audioControlWidget) {
         XPDestroyWidget(audioControlWidget, 1);
         audioControlWidget = nullptr;
     }
+    tapeWindow.destroy();
+    scopeWindow.destroy();
     XPLMDestroyMenu(menuId);
+    timer.mark("window and menu");
+
     XPLMUnregisterFlightLoopCallback(CheckAOAAndPlayTone, nullptr);
+    XPLMUnregisterFlightLoopCallback(init_sound, nullptr);
+    XPLMUnregisterFlightLoopCallback(FlushLog, nullptr);
+    publishedDataRefs.unregisterAll();
+    timer.mark("callbacks and datarefs");
+
     cleanupAudio();
+    timer.mark("audio");
+
+    flightRecorder.wait();   // trimming the recording closed above
+    profileWatcher.stop();
+    profileStore.stop();     // lets a pending save finish
+    aoaAnalyzer.stop();
+    timer.mark("background threads");
+
+    LogAlErrorSites();
+    alCheckSetErrorHandler(nullptr);
+    LogPhaseTimer(timer);
+    pluginLog().stop();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Plugin enable
 PLUGIN_API int XPluginEnable(void) {
+    RestoreWarmState();
+    RequestAircraftProfile();
     return 1;
 }
 
@@ -822,12 +1805,27 @@ PLUGIN_API int XPluginEnable(void) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Plugin disable
 PLUGIN_API void XPluginDisable(void) {
+    SaveWarmState();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Plugin receive message
 PLUGIN_API void XPluginReceiveMessage(XPLMPluginID inFromWho, int inMessage, void *inParam) {
+    // A new aircraft or plugin may have published or replaced datarefs, look them all up again
+    if ((inMessage == XPLM_MSG_PLANE_LOADED && (intptr_t)inParam == XPLM_USER_AIRCRAFT) ||
+        inMessage == XPLM_MSG_DATAREFS_ADDED) {
+        flightDataSet.resolve();
+
+        // Fall back to alpha if the new aircraft doesn't publish the selected source
+        if (!flightDataSet.isResolved(aoaSourceIndex)) {
+            SelectAoaSource(0);
+        }
+    }
+
+    if (inMessage == XPLM_MSG_PLANE_LOADED && (intptr_t)inParam == XPLM_USER_AIRCRAFT) {
+        RequestAircraftProfile();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -835,13 +1833,15 @@ PLUGIN_API void XPluginReceiveMessage(XPLMPluginID inFromWho, int inMessage, voi
 // Update cleanup function
 void cleanupAudio() {
     if (context) {
-        alSourceStop(audioSource);
-        alDeleteSources(1, &audioSource);
-        alDeleteBuffers(1, &audioBufferNormal);
-        alDeleteBuffers(1, &audioBufferHigh);
+        toneRenderer.stop();
+        AL_CHECKED(alSourceStop(audioSource));
+        AL_CHECKED(alDeleteSources(1, &audioSource));
+        AL_CHECKED(alDeleteBuffers(1, &toneBuffers.normal));
+        AL_CHECKED(alDeleteBuffers(1, &toneBuffers.high));
+        toneRenderer.deleteRetired();
         
-        alcMakeContextCurrent(nullptr);
-        alcDestroyContext(context);
+        ALC_CHECKED(device, alcMakeContextCurrent(nullptr));
+        ALC_CHECKED(device, alcDestroyContext(context));
         context = nullptr;
     }
     
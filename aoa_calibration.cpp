@@ -0,0 +1,138 @@
+#include "aoa_calibration.h"
+
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void LeastSquaresLine::reset() {
+    n = 0;
+    meanX = 0.0;
+    meanY = 0.0;
+    m2X = 0.0;
+    m2Y = 0.0;
+    cXY = 0.0;
+}
+
+void LeastSquaresLine::add(double x, double y) {
+    n++;
+    double dx = x - meanX;
+    double dy = y - meanY;
+    meanX += dx / n;
+    meanY += dy / n;
+    m2X += dx * (x - meanX);
+    m2Y += dy * (y - meanY);
+    cXY += dx * (y - meanY);
+}
+
+double LeastSquaresLine::slope() const {
+    return m2X > 0.0 ? cXY / m2X : 0.0;
+}
+
+double LeastSquaresLine::rSquared() const {
+    return m2X > 0.0 && m2Y > 0.0 ? cXY * cXY / (m2X * m2Y) : 0.0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+AoaCalibration::AoaCalibration()
+    : current(defaultAoaThresholds()),
+      peakAoa(0.0f),
+      peakIas(0.0f),
+      peakX(0.0f),
+      startFlapRatio(-1.0f),
+      frames(0),
+      running(false),
+      resultValid(false),
+      failureReason("not run"),
+      calibration() {
+}
+
+void AoaCalibration::start(const AoaThresholds& thresholds) {
+    current = thresholds;
+    fit.reset();
+    fitAtPeak.reset();
+    peakAoa = -1000.0f;
+    peakIas = 0.0f;
+    peakX = 0.0f;
+    startFlapRatio = -1.0f;
+    frames = 0;
+    running = true;
+    resultValid = false;
+    failureReason = "running";
+}
+
+void AoaCalibration::stop() {
+    if (running) {
+        finish();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool AoaCalibration::addFrame(float aoa, float ias, float gLoad, float flapRatio) {
+    if (!running || ias < current.iasToneEnable || ias <= 0.0f || gLoad <= 0.0f) {
+        return false;
+    }
+
+    if (startFlapRatio < 0.0f) {
+        startFlapRatio = flapRatio;
+    } else if (std::fabs(flapRatio - startFlapRatio) > CALIBRATION_MAX_FLAP_CHANGE) {
+        running = false;
+        failureReason = "flaps moved during the run";
+        return true;
+    }
+
+    // Proportional to the lift coefficient, scaled so the numbers are near 1 at ordinary speeds
+    float speed = 100.0f / ias;
+    float x = gLoad * speed * speed;
+
+    fit.add(x, aoa);
+    frames++;
+
+    if (aoa > peakAoa) {
+        peakAoa = aoa;
+        peakIas = ias;
+        peakX = x;
+        fitAtPeak = fit;
+    } else if (peakAoa - aoa > CALIBRATION_BREAK_DEGREES && fitAtPeak.count() >= CALIBRATION_MIN_SAMPLES) {
+        finish();
+        return true;
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AoaCalibration::finish() {
+    running = false;
+    resultValid = false;
+
+    const LeastSquaresLine& line = fitAtPeak;
+    if (line.count() < CALIBRATION_MIN_SAMPLES) {
+        failureReason = "too few samples above the tone IAS";
+        return;
+    }
+    if (line.slope() <= 0.0 || line.rSquared() < CALIBRATION_MIN_R_SQUARED) {
+        failureReason = "AOA didn't follow G / IAS^2, fly a steadier deceleration";
+        return;
+    }
+
+    float zeroLift = static_cast<float>(line.intercept());
+    float slope = static_cast<float>(line.slope());
+    auto aoaAt = [&](float speedRatio) {
+        return zeroLift + slope * peakX / (speedRatio * speedRatio);
+    };
+
+    calibration.samples = line.count();
+    calibration.zeroLiftAoa = zeroLift;
+    calibration.slope = slope;
+    calibration.rSquared = static_cast<float>(line.rSquared());
+    calibration.stallAoa = peakAoa;
+    calibration.stallIas = peakIas;
+    calibration.flapRatio = startFlapRatio;
+    calibration.proposed = AoaThresholds{aoaAt(CALIBRATION_LDMAX_SPEED), aoaAt(CALIBRATION_ONSPEED_FAST_SPEED),
+                                         aoaAt(CALIBRATION_ONSPEED_SLOW_SPEED), aoaAt(CALIBRATION_STALL_WARNING_SPEED),
+                                         current.iasToneEnable};
+    resultValid = true;
+    failureReason = "";
+}
@@ -0,0 +1,99 @@
+#ifndef AOA_CALIBRATION_H
+#define AOA_CALIBRATION_H
+
+#include "aoa_engine.h"
+
+#define CALIBRATION_MIN_SAMPLES         120     // Frames the fit needs before it is trusted
+#define CALIBRATION_MIN_R_SQUARED       0.9f    // Worse than this and the run wasn't steady enough
+#define CALIBRATION_BREAK_DEGREES       2.0f    // AOA this far below its peak means the wing has stalled
+#define CALIBRATION_MAX_FLAP_CHANGE     0.05f   // Moving the flaps more than this spoils the run
+
+// Where the setpoints go, as multiples of the stall speed measured in the run
+#define CALIBRATION_LDMAX_SPEED             1.5f
+#define CALIBRATION_ONSPEED_FAST_SPEED      1.35f
+#define CALIBRATION_ONSPEED_SLOW_SPEED      1.25f
+#define CALIBRATION_STALL_WARNING_SPEED     1.1f
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Straight line y = intercept + slope * x fitted by least squares as samples stream in.
+// Keeps running means and co-moments (Welford), so memory is constant, each add() is a handful of flops and
+// the result doesn't lose precision over tens of thousands of samples the way raw sums of squares do.
+class LeastSquaresLine {
+public:
+    LeastSquaresLine() { reset(); }
+
+    void reset();
+    void add(double x, double y);
+
+    long long count() const { return n; }
+    double slope() const;
+    double intercept() const { return meanY - slope() * meanX; }
+    double rSquared() const;
+
+private:
+    long long n;
+    double meanX;
+    double meanY;
+    double m2X;         // sum of squared deviations from meanX
+    double m2Y;
+    double cXY;         // sum of co-deviations
+};
+
+struct CalibrationResult {
+    long long samples;
+    float zeroLiftAoa;      // fitted AOA at zero lift, degrees
+    float slope;            // degrees per unit of G * (100 kt / IAS)^2
+    float rSquared;
+    float stallAoa;         // peak AOA before the break
+    float stallIas;         // IAS at the peak
+    float flapRatio;        // flap setting the setpoints are good for
+    AoaThresholds proposed;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Calibrates the AOA setpoints from one deceleration to the stall, the way the OnSpeed hardware is set up.
+// With lift equal to weight times G, the lift coefficient goes as G / IAS^2 and AOA is linear in it over the
+// unstalled range, so each frame adds one (G / IAS^2, AOA) point to a streaming fit. The fit is snapshotted at
+// every new AOA peak and the run ends on its own once AOA drops CALIBRATION_BREAK_DEGREES past the peak, so
+// post-stall samples never reach the fit. The setpoints then follow from the fitted line at fixed fractions
+// of the stall lift coefficient (CL / CLmax = (Vs / V)^2). Nothing is stored per frame.
+class AoaCalibration {
+public:
+    AoaCalibration();
+
+    // Begin a run. IAS below current.iasToneEnable is ignored and passed through to the proposal.
+    void start(const AoaThresholds& current);
+
+    // End the run now, e.g. from the UI, and work out the result from what was seen so far
+    void stop();
+
+    bool isRunning() const { return running; }
+
+    // One frame of spike-filtered AOA. Returns true when this frame ended the run.
+    bool addFrame(float aoa, float ias, float gLoad, float flapRatio);
+
+    // After a run: whether it produced setpoints, and why not if it didn't
+    bool hasResult() const { return resultValid; }
+    const CalibrationResult& result() const { return calibration; }
+    const char* failure() const { return failureReason; }
+
+private:
+    void finish();
+
+    AoaThresholds current;
+    LeastSquaresLine fit;
+    LeastSquaresLine fitAtPeak;     // the fit as it was at the highest AOA so far
+    float peakAoa;
+    float peakIas;
+    float peakX;
+    float startFlapRatio;
+    long long frames;
+    bool running;
+    bool resultValid;
+    const char* failureReason;
+    CalibrationResult calibration;
+};
+
+#endif // AOA_CALIBRATION_H
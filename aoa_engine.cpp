@@ -0,0 +1,188 @@
+#include "aoa_engine.h"
+
+#include <cmath>
+
+static const double TWO_PI = 6.283185307179586;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AoaFilter::setWindow(int window) {
+    historyWindow = window < 1 ? 1 : window > AOA_HISTORY_MAX ? AOA_HISTORY_MAX : window;
+    reset();
+}
+
+void AoaFilter::reset(float lastValid) {
+    for (int i = 0; i < AOA_HISTORY_MAX; i++) {
+        history[i] = 0.0f;
+    }
+    historyCount = 0;
+    historyNext = 0;
+    lastValidAoa = lastValid;
+    lastSampleAoa = lastValid;
+    averageAoa = lastValid;
+    spikeRejected = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+float AoaFilter::update(float aoa) {
+    // Spike filter - if change is too large, use last valid value
+    spikeRejected = std::abs(aoa - lastValidAoa) > maxChange;
+    if (spikeRejected) {
+        aoa = lastValidAoa;
+    } else {
+        lastValidAoa = aoa;
+    }
+    lastSampleAoa = aoa;
+
+    // Overwrite the oldest sample once the ring is full
+    history[historyNext] = aoa;
+    historyNext = (historyNext + 1) % historyWindow;
+    if (historyCount < historyWindow) {
+        historyCount++;
+    }
+
+    // Sum the whole ring every time rather than keeping a running total so float error can't build up
+    float sum = 0.0f;
+    for (int i = 0; i < historyCount; i++) {
+        sum += history[i];
+    }
+    averageAoa = sum / historyCount;
+
+    return averageAoa;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AoaFilter::saveState(AoaFilterState& state) const {
+    for (int i = 0; i < AOA_HISTORY_MAX; i++) {
+        state.history[i] = history[i];
+    }
+    state.window = historyWindow;
+    state.count = historyCount;
+    state.next = historyNext;
+    state.lastValidAoa = lastValidAoa;
+    state.lastSampleAoa = lastSampleAoa;
+    state.averageAoa = averageAoa;
+}
+
+bool AoaFilter::restoreState(const AoaFilterState& state) {
+    if (state.window < 1 || state.window > AOA_HISTORY_MAX || state.count < 0 || state.count > state.window ||
+        state.next < 0 || state.next >= state.window || !std::isfinite(state.lastValidAoa) ||
+        !std::isfinite(state.lastSampleAoa) || !std::isfinite(state.averageAoa)) {
+        return false;
+    }
+    for (int i = 0; i < state.count; i++) {
+        if (!std::isfinite(state.history[i])) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < AOA_HISTORY_MAX; i++) {
+        history[i] = i < state.count ? state.history[i] : 0.0f;
+    }
+    historyWindow = state.window;
+    historyCount = state.count;
+    historyNext = state.next;
+    lastValidAoa = state.lastValidAoa;
+    lastSampleAoa = state.lastSampleAoa;
+    averageAoa = state.averageAoa;
+    spikeRejected = false;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool isValidAoaThresholds(const AoaThresholds& t) {
+    // Written so NaNs fail too
+    return t.belowLDMax < t.belowOnSpeed && t.belowOnSpeed < t.onSpeedMax && t.onSpeedMax < t.aboveOnSpeedMax &&
+           t.iasToneEnable >= 0.0f;
+}
+
+bool isValidToneSettings(const ToneSettings& s) {
+    auto validFrequency = [](float hz) { return hz >= TONE_FREQUENCY_MIN && hz <= TONE_FREQUENCY_MAX; };
+    auto validRange = [](float low, float high) { return low > 0.0f && low <= high && high <= TONE_PULSE_RATE_MAX; };
+    return validFrequency(s.normalFrequency) && validFrequency(s.highFrequency) &&
+           validRange(s.belowOnSpeedPulseMin, s.belowOnSpeedPulseMax) &&
+           validRange(s.aboveOnSpeedPulseMin, s.aboveOnSpeedPulseMax) &&
+           validRange(s.stallPulseRate, s.stallPulseRate) &&
+           s.volume >= 0.0f && s.volume <= 1.0f;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+ToneState computeToneState(float avgAoa, float ias, const AoaThresholds& thresholds, const ToneSettings& settings) {
+    if (ias < thresholds.iasToneEnable) {
+        return ToneState{ToneZone::BelowIAS, 0.0f, 0.0f};
+    }
+    return computeToneState(avgAoa, thresholds, settings);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+ToneState computeToneState(float avgAoa, const AoaThresholds& thresholds, const ToneSettings& settings) {
+    if (avgAoa > thresholds.aboveOnSpeedMax) {
+        return ToneState{ToneZone::Stall, settings.highFrequency, settings.stallPulseRate};
+    }
+
+    if (avgAoa > thresholds.onSpeedMax) {
+        // Variable pulse rate for Above OnSpeed condition
+        float t = (avgAoa - thresholds.onSpeedMax) / (thresholds.aboveOnSpeedMax - thresholds.onSpeedMax);
+        float pulseRate = settings.aboveOnSpeedPulseMin +
+                          t * (settings.aboveOnSpeedPulseMax - settings.aboveOnSpeedPulseMin);
+        return ToneState{ToneZone::AboveOnSpeed, settings.highFrequency, pulseRate};
+    }
+
+    if (avgAoa >= thresholds.belowOnSpeed) {
+        return ToneState{ToneZone::OnSpeed, settings.normalFrequency, 0.0f};
+    }
+
+    if (avgAoa >= thresholds.belowLDMax) {
+        float t = (avgAoa - thresholds.belowLDMax) / (thresholds.belowOnSpeed - thresholds.belowLDMax);
+        float pulseRate = settings.belowOnSpeedPulseMin +
+                          t * (settings.belowOnSpeedPulseMax - settings.belowOnSpeedPulseMin);
+        return ToneState{ToneZone::BelowOnSpeed, settings.normalFrequency, pulseRate};
+    }
+
+    return ToneState{ToneZone::BelowLDMax, 0.0f, 0.0f};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool isPulsingZone(ToneZone zone) {
+    return zone == ToneZone::BelowOnSpeed || zone == ToneZone::AboveOnSpeed || zone == ToneZone::Stall;
+}
+
+bool isHighToneZone(ToneZone zone) {
+    return zone == ToneZone::AboveOnSpeed || zone == ToneZone::Stall;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const char* toneZoneName(ToneZone zone) {
+    switch (zone) {
+        case ToneZone::BelowIAS:        return "BelowIAS";
+        case ToneZone::BelowLDMax:      return "BelowLDMax";
+        case ToneZone::BelowOnSpeed:    return "BelowOnSpeed";
+        case ToneZone::OnSpeed:         return "OnSpeed";
+        case ToneZone::AboveOnSpeed:    return "AboveOnSpeed";
+        case ToneZone::Stall:           return "Stall";
+    }
+    return "?";
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<int16_t> generateTone(float frequency, float duration, int sampleRate) {
+    std::vector<int16_t> buffer;
+    int samples = static_cast<int>(duration * sampleRate);
+    buffer.reserve(samples);
+
+    for (int i = 0; i < samples; i++) {
+        float t = static_cast<float>(i) / sampleRate;
+        float value = 32767.0f * static_cast<float>(std::sin(TWO_PI * frequency * t));
+        buffer.push_back(static_cast<int16_t>(value));
+    }
+
+    return buffer;
+}
@@ -0,0 +1,172 @@
+#ifndef AOA_ENGINE_H
+#define AOA_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// AOA filter and tone zone logic.
+// This is the per-frame core of the plugin. It does not touch the XPLM or OpenAL and the per-frame calls never
+// allocate, so they can run on the sim thread every frame and be driven directly by offline tools.
+
+// Default tone configuration, the starting point for ToneSettings
+#define TONE_NORMAL_FREQ       400.0f   // Normal frequency in Hz
+#define TONE_HIGH_FREQ         1600.0f  // High frequency in Hz
+#define PULSE_RATE_NORMAL      6.2f     // Standard pulse rate
+#define PULSE_RATE_STALL       20.0f    // Stall warning pulse rate
+#define DEFAULT_VOLUME          1.0f    // Default volume level (0.0 to 1.0)
+
+// Pulse rate range for the Below OnSpeed zone
+#define PULSE_RATE_MIN         1.5f    // Minimum pulses per second at AOA_BELOW_LDMAX
+#define PULSE_RATE_MAX         8.2f    // Maximum pulses per second at AOA_BELOW_ONSPEED
+
+// Pulse rate range for the Above OnSpeed zone
+#define ABOVE_ONSPEED_PULSE_MIN  1.5f    // Minimum pulses per second at AOA_ONSPEED_MAX
+#define ABOVE_ONSPEED_PULSE_MAX  6.2f    // Maximum pulses per second at AOA_ABOVE_ONSPEED_MAX
+
+// Default AOA ranges for the different states
+#define DEFAULT_AOA_BELOW_LDMAX         6.0f    // Below this is "Below LDMax" - no tone
+#define DEFAULT_AOA_BELOW_ONSPEED       7.3f    // Between LDMax and this is "Below OnSpeed"
+#define DEFAULT_AOA_ONSPEED_MAX         9.6f    // Between Below OnSpeed and this is "OnSpeed"
+#define DEFAULT_AOA_ABOVE_ONSPEED_MAX   12.5f   // Above this is "Above OnSpeed"
+#define DEFAULT_AOA_IAS_TONE_ENABLE     25.0f   // IAS (knots) above this value will enable the tone
+
+// Filter configuration
+const int AOA_HISTORY_SIZE = 20;        // Number of samples in the moving average
+const int AOA_HISTORY_MAX = 64;         // Longest moving average a filter can be set to
+const float MAX_AOA_CHANGE = 6.0f;      // Default maximum allowed change in degrees
+
+// AOA/IAS thresholds that split the tone into zones
+struct AoaThresholds {
+    float belowLDMax;           // Below this is "Below LDMax" - no tone
+    float belowOnSpeed;         // Between LDMax and this is "Below OnSpeed"
+    float onSpeedMax;           // Between Below OnSpeed and this is "OnSpeed"
+    float aboveOnSpeedMax;      // Above this is "Above OnSpeed"
+    float iasToneEnable;        // IAS (knots) above this value will enable the tone
+};
+
+// Tone frequencies, pulse rates and volume. Defaults from the defines above, editable at runtime.
+struct ToneSettings {
+    float normalFrequency;          // Hz, below OnSpeed and the OnSpeed steady tone
+    float highFrequency;            // Hz, above OnSpeed and the stall warning
+    float belowOnSpeedPulseMin;     // pulses per second at belowLDMax
+    float belowOnSpeedPulseMax;     // pulses per second at belowOnSpeed
+    float aboveOnSpeedPulseMin;     // pulses per second at onSpeedMax
+    float aboveOnSpeedPulseMax;     // pulses per second at aboveOnSpeedMax
+    float stallPulseRate;
+    float volume;                   // 0.0 to 1.0
+};
+
+// Limits isValidToneSettings checks against
+#define TONE_FREQUENCY_MIN      100.0f
+#define TONE_FREQUENCY_MAX      4000.0f
+#define TONE_PULSE_RATE_MAX     30.0f
+
+enum class ToneZone {
+    BelowIAS,           // Too slow, no tone
+    BelowLDMax,         // No tone
+    BelowOnSpeed,       // Slow low-frequency pulses, faster as AOA increases
+    OnSpeed,            // Steady low-frequency tone
+    AboveOnSpeed,       // High-frequency pulses, faster as AOA increases
+    Stall               // Fast high-frequency pulses
+};
+
+// What the audio should be doing for a given AOA
+struct ToneState {
+    ToneZone zone;
+    float frequency;    // Hz, 0 when silent
+    float pulseRate;    // pulses per second, 0 when silent or steady
+};
+
+// Everything an AoaFilter holds, so a filter can carry on where another left off
+struct AoaFilterState {
+    float history[AOA_HISTORY_MAX];
+    int32_t window;
+    int32_t count;
+    int32_t next;
+    float lastValidAoa;
+    float lastSampleAoa;
+    float averageAoa;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Spike filter followed by a moving average over a fixed ring of samples
+class AoaFilter {
+public:
+    explicit AoaFilter(int window = AOA_HISTORY_SIZE, float spikeLimit = MAX_AOA_CHANGE)
+        : maxChange(spikeLimit) { setWindow(window); }
+
+    // Moving average length, clamped to 1..AOA_HISTORY_MAX. Clears the history.
+    void setWindow(int window);
+    int window() const { return historyWindow; }
+
+    // Samples further than this from the last valid one, in degrees, are rejected as spikes
+    void setSpikeLimit(float spikeLimit) { maxChange = spikeLimit; }
+    float spikeLimit() const { return maxChange; }
+
+    // Clear the history. The next sample is compared against lastValidAoa for spike rejection.
+    void reset(float lastValidAoa = 0.0f);
+
+    // Feed one raw AOA sample and return the moving average
+    float update(float aoa);
+
+    float lastSample() const { return lastSampleAoa; }    // sample after spike rejection
+    float average() const { return averageAoa; }
+    float lastValid() const { return lastValidAoa; }        // what the next sample is checked against
+    bool lastWasSpike() const { return spikeRejected; }
+
+    void saveState(AoaFilterState& state) const;
+
+    // Returns false, leaving the filter alone, if state is out of range or not finite
+    bool restoreState(const AoaFilterState& state);
+
+private:
+    float history[AOA_HISTORY_MAX];
+    float maxChange;
+    int historyWindow;
+    int historyCount;
+    int historyNext;
+    float lastValidAoa;
+    float lastSampleAoa;
+    float averageAoa;
+    bool spikeRejected;
+};
+
+inline ToneSettings defaultToneSettings() {
+    return ToneSettings{TONE_NORMAL_FREQ, TONE_HIGH_FREQ, PULSE_RATE_MIN, PULSE_RATE_MAX, ABOVE_ONSPEED_PULSE_MIN,
+                        ABOVE_ONSPEED_PULSE_MAX, PULSE_RATE_STALL, DEFAULT_VOLUME};
+}
+
+// Setpoints strictly increasing and the IAS gate not negative, so every zone has some width
+bool isValidAoaThresholds(const AoaThresholds& thresholds);
+
+// Frequencies in range, pulse rates positive and each range increasing, volume 0 to 1
+bool isValidToneSettings(const ToneSettings& settings);
+
+// Work out the zone, tone frequency and pulse rate for a filtered AOA and IAS
+ToneState computeToneState(float avgAoa, float ias, const AoaThresholds& thresholds,
+                           const ToneSettings& settings = defaultToneSettings());
+
+// Same as above but ignoring the IAS gate, used by the pulse thread once the flight loop has decided to play
+ToneState computeToneState(float avgAoa, const AoaThresholds& thresholds,
+                           const ToneSettings& settings = defaultToneSettings());
+
+bool isPulsingZone(ToneZone zone);
+
+// Zones that sound the high tone
+bool isHighToneZone(ToneZone zone);
+
+// Generate a sine wave tone as 16 bit mono samples. Called once per buffer at startup, not per frame.
+std::vector<int16_t> generateTone(float frequency, float duration, int sampleRate = 44100);
+
+// Short name for logs and reports
+const char* toneZoneName(ToneZone zone);
+
+inline AoaThresholds defaultAoaThresholds() {
+    return AoaThresholds{DEFAULT_AOA_BELOW_LDMAX, DEFAULT_AOA_BELOW_ONSPEED, DEFAULT_AOA_ONSPEED_MAX,
+                         DEFAULT_AOA_ABOVE_ONSPEED_MAX, DEFAULT_AOA_IAS_TONE_ENABLE};
+}
+
+#endif // AOA_ENGINE_H
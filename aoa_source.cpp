@@ -0,0 +1,163 @@
+#include "aoa_source.h"
+
+#include <cmath>
+#include <cstdio>
+
+// sim/cockpit2/gauges/indicators/aoa_angle_degrees is what AOA-Tone-FlyOnSpeed.xml animates from
+const AoaSourceInfo AOA_SOURCES[AOA_SOURCE_COUNT] = {
+    {"alpha",           "sim/flightmodel/position/alpha"},
+    {"AoA_pilot",       "sim/cockpit2/gauges/indicators/AoA_pilot"},
+    {"aoa_angle_deg",   "sim/cockpit2/gauges/indicators/aoa_angle_degrees"},
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+AoaSourceCharacterizer::AoaSourceCharacterizer()
+    : capacity(0),
+      count(0),
+      running(false) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AoaSourceCharacterizer::start(int maxFrames) {
+    capacity = maxFrames;
+    count = 0;
+    samples.assign(capacity * AOA_SOURCE_COUNT, 0.0f);
+    frameTimes.assign(capacity, 0.0f);
+    running = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AoaSourceCharacterizer::addFrame(float elapsed, const float* aoa) {
+    if (!running) {
+        return;
+    }
+
+    for (int i = 0; i < AOA_SOURCE_COUNT; i++) {
+        samples[count * AOA_SOURCE_COUNT + i] = aoa[i];
+    }
+    frameTimes[count] = elapsed;
+
+    if (++count >= capacity) {
+        running = false;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AoaSourceCharacterizer::takeSegment(AoaSourceCharacterizer& other) {
+    samples.swap(other.samples);
+    frameTimes.swap(other.frameTimes);
+    capacity = other.capacity;
+    count = other.count;
+    running = false;
+    other.count = 0;
+    other.running = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AoaSourceCharacterizer::analyze(int reference, int maxLag, AoaSourceReport* reports) const {
+    // Average frame time turns the lag in frames into ms
+    double totalTime = 0.0;
+    for (int i = 0; i < count; i++) {
+        totalTime += frameTimes[i];
+    }
+    double frameMs = count > 0 ? 1000.0 * totalTime / count : 0.0;
+
+    double mean[AOA_SOURCE_COUNT];
+    double stddev[AOA_SOURCE_COUNT];
+    for (int s = 0; s < AOA_SOURCE_COUNT; s++) {
+        double sum = 0.0;
+        for (int i = 0; i < count; i++) {
+            sum += sample(i, s);
+        }
+        mean[s] = count > 0 ? sum / count : 0.0;
+
+        double sq = 0.0;
+        for (int i = 0; i < count; i++) {
+            double d = sample(i, s) - mean[s];
+            sq += d * d;
+        }
+        stddev[s] = count > 0 ? std::sqrt(sq / count) : 0.0;
+    }
+
+    for (int s = 0; s < AOA_SOURCE_COUNT; s++) {
+        AoaSourceReport& report = reports[s];
+        report.samples = count;
+        report.lagFrames = 0.0f;
+        report.lagMs = 0.0f;
+        report.correlation = 0.0f;
+        report.noiseVariance = 0.0f;
+
+        // For white noise on a smooth signal the second difference x[i-1] - 2x[i] + x[i+1] has variance 6*sigma^2
+        if (count >= 3) {
+            double sq = 0.0;
+            for (int i = 1; i < count - 1; i++) {
+                double d2 = sample(i - 1, s) - 2.0 * sample(i, s) + sample(i + 1, s);
+                sq += d2 * d2;
+            }
+            report.noiseVariance = static_cast<float>(sq / (count - 2) / 6.0);
+        }
+
+        // Normalized cross-correlation; if this source lags by k frames then s[i + k] lines up with ref[i]
+        if (stddev[s] <= 0.0 || stddev[reference] <= 0.0) {
+            continue;
+        }
+        double best = -2.0;
+        int bestLag = 0;
+        for (int lag = -maxLag; lag <= maxLag; lag++) {
+            double sum = 0.0;
+            int n = 0;
+            for (int i = 0; i < count; i++) {
+                int j = i + lag;
+                if (j < 0 || j >= count) {
+                    continue;
+                }
+                sum += (sample(i, reference) - mean[reference]) * (sample(j, s) - mean[s]);
+                n++;
+            }
+            if (n == 0) {
+                continue;
+            }
+            double r = sum / n / (stddev[reference] * stddev[s]);
+            if (r > best) {
+                best = r;
+                bestLag = lag;
+            }
+        }
+        report.lagFrames = static_cast<float>(bestLag);
+        report.lagMs = static_cast<float>(bestLag * frameMs);
+        report.correlation = static_cast<float>(best);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool AoaSourceCharacterizer::writeCsv(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "time");
+    for (int s = 0; s < AOA_SOURCE_COUNT; s++) {
+        fprintf(file, ",%s", AOA_SOURCES[s].label);
+    }
+    fprintf(file, "\n");
+
+    double time = 0.0;
+    for (int i = 0; i < count; i++) {
+        time += frameTimes[i];
+        fprintf(file, "%.4f", time);
+        for (int s = 0; s < AOA_SOURCE_COUNT; s++) {
+            fprintf(file, ",%.4f", sample(i, s));
+        }
+        fprintf(file, "\n");
+    }
+
+    fclose(file);
+    return true;
+}
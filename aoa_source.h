@@ -0,0 +1,67 @@
+#ifndef AOA_SOURCE_H
+#define AOA_SOURCE_H
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Candidate AOA datarefs. Which one tracks the real wing best differs per aircraft, so the source is picked
+// at runtime and can be characterized in flight: every candidate is logged side by side, then each one is
+// compared against a reference for lag (cross-correlation peak) and noise (variance of the second difference).
+
+#define AOA_SOURCE_COUNT               3
+#define AOA_CHARACTERIZE_MAX_FRAMES    30000   // About 5 minutes at 100 fps
+#define AOA_CHARACTERIZE_MAX_LAG       30      // Frames either side searched for the correlation peak
+
+struct AoaSourceInfo {
+    const char* label;      // short name for the UI
+    const char* dataRef;
+};
+
+extern const AoaSourceInfo AOA_SOURCES[AOA_SOURCE_COUNT];
+
+struct AoaSourceReport {
+    int samples;
+    float lagFrames;        // positive means this source lags the reference
+    float lagMs;
+    float correlation;      // normalized cross-correlation at the peak
+    float noiseVariance;    // estimated white noise variance, deg^2
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Records every AOA source each frame over a flight segment and works out how they compare.
+// start() allocates the whole segment up front so addFrame() is just a copy.
+class AoaSourceCharacterizer {
+public:
+    AoaSourceCharacterizer();
+
+    void start(int maxFrames = AOA_CHARACTERIZE_MAX_FRAMES);
+    void stop() { running = false; }
+    bool isRunning() const { return running; }
+    int frameCount() const { return count; }
+
+    // aoa holds one value per source. Stops by itself once the segment is full.
+    void addFrame(float elapsed, const float* aoa);
+
+    // Move other's recorded segment here without copying it. other is left stopped and empty, holding this
+    // one's old buffers for its next start().
+    void takeSegment(AoaSourceCharacterizer& other);
+
+    // Compare every source against the reference source
+    void analyze(int reference, int maxLag, AoaSourceReport* reports) const;
+
+    // Dump the recorded segment, one row per frame
+    bool writeCsv(const char* path) const;
+
+private:
+    float sample(int frame, int source) const { return samples[frame * AOA_SOURCE_COUNT + source]; }
+
+    std::vector<float> samples;         // interleaved, AOA_SOURCE_COUNT per frame
+    std::vector<float> frameTimes;
+    int capacity;
+    int count;
+    bool running;
+};
+
+#endif // AOA_SOURCE_H
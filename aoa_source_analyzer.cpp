@@ -0,0 +1,102 @@
+#include "aoa_source_analyzer.h"
+
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+AoaSourceAnalyzer::AoaSourceAnalyzer()
+    : running(false),
+      pending(false),
+      reference(0),
+      result(),
+      resultReady(false) {
+    csvPath[0] = '\0';
+}
+
+AoaSourceAnalyzer::~AoaSourceAnalyzer() {
+    stop();
+}
+
+void AoaSourceAnalyzer::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&AoaSourceAnalyzer::threadFunction, this);
+}
+
+void AoaSourceAnalyzer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The segment is swapped, not copied, so this is cheap enough for the sim thread
+bool AoaSourceAnalyzer::requestAnalysis(AoaSourceCharacterizer& characterizer, int analysisReference,
+                                        const char* path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending) {
+            return false;
+        }
+        segment.takeSegment(characterizer);
+        reference = analysisReference;
+        snprintf(csvPath, sizeof(csvPath), "%s", path);
+        pending = true;
+    }
+    wake.notify_one();
+    return true;
+}
+
+bool AoaSourceAnalyzer::takeResult(AoaSourceAnalysis& analysis) {
+    if (!resultReady.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!resultReady.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    analysis = result;
+    resultReady.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The work happens with the lock released; requestAnalysis won't touch the segment until pending is cleared
+void AoaSourceAnalyzer::threadFunction() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return !running || pending; });
+
+        if (pending) {
+            AoaSourceAnalysis analysis;
+            int analysisReference = reference;
+            snprintf(analysis.csvPath, sizeof(analysis.csvPath), "%s", csvPath);
+            lock.unlock();
+
+            analysis.frames = segment.frameCount();
+            segment.analyze(analysisReference, AOA_CHARACTERIZE_MAX_LAG, analysis.reports);
+            analysis.csvWritten = segment.writeCsv(analysis.csvPath);
+
+            lock.lock();
+            result = analysis;
+            pending = false;
+            resultReady.store(true, std::memory_order_release);
+            continue;
+        }
+
+        if (!running) {
+            return;
+        }
+    }
+}
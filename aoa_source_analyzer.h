@@ -0,0 +1,63 @@
+#ifndef AOA_SOURCE_ANALYZER_H
+#define AOA_SOURCE_ANALYZER_H
+
+#include "aoa_source.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define AOA_SOURCE_CSV_PATH_MAX     512
+
+struct AoaSourceAnalysis {
+    AoaSourceReport reports[AOA_SOURCE_COUNT];
+    int frames;
+    bool csvWritten;
+    char csvPath[AOA_SOURCE_CSV_PATH_MAX];
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Compares the AOA sources over a finished characterization segment, and writes the segment out as CSV, on a
+// background thread. A full segment is 30000 frames: the cross-correlation and a couple of megabytes of text
+// are far too much for one sim frame.
+// The sim thread hands the segment over without copying it and polls for the result once a frame; polling is
+// one atomic load unless a result is in. One segment at a time.
+class AoaSourceAnalyzer {
+public:
+    AoaSourceAnalyzer();
+    ~AoaSourceAnalyzer();
+
+    void start();
+
+    // Finishes an analysis in progress before returning
+    void stop();
+
+    // Take over the characterizer's segment, leaving it stopped and empty, and compare every source against
+    // source reference. Returns false, and leaves the characterizer alone, while the last one is still going.
+    bool requestAnalysis(AoaSourceCharacterizer& characterizer, int reference, const char* csvPath);
+
+    // Returns true, once, when a requested analysis has finished
+    bool takeResult(AoaSourceAnalysis& analysis);
+
+private:
+    void threadFunction();
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+
+    // Request, guarded by mutex. While pending the worker owns segment.
+    bool pending;
+    AoaSourceCharacterizer segment;
+    int reference;
+    char csvPath[AOA_SOURCE_CSV_PATH_MAX];
+
+    // Finished analysis, guarded by mutex, flagged by resultReady
+    AoaSourceAnalysis result;
+    std::atomic<bool> resultReady;
+};
+
+#endif // AOA_SOURCE_ANALYZER_H
@@ -0,0 +1,71 @@
+#include "aoa_tape.h"
+
+#include <cmath>
+#include <cstdio>
+
+static const float TAPE_PADDING = 10.0f;         // pixels between the window edge and the tape
+static const float TAPE_WIDTH_MAX = 60.0f;
+static const float TICK_SPACING_MIN = 14.0f;     // pixels, enough for a line of text
+
+// Indexed by ToneZone
+static const float ZONE_COLORS[][4] = {
+    {0.0f, 0.0f, 0.0f, 0.0f},       // BelowIAS
+    {0.35f, 0.35f, 0.40f, 0.9f},    // BelowLDMax
+    {0.90f, 0.80f, 0.20f, 0.9f},    // BelowOnSpeed
+    {0.20f, 0.80f, 0.30f, 0.9f},    // OnSpeed
+    {1.00f, 0.55f, 0.10f, 0.9f},    // AboveOnSpeed
+    {0.90f, 0.15f, 0.15f, 0.9f},    // Stall
+};
+
+const float* toneZoneColor(ToneZone zone) {
+    return ZONE_COLORS[static_cast<int>(zone)];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void layoutAoaTape(AoaTapeLayout& layout, int left, int top, int right, int bottom, const AoaThresholds& thresholds) {
+    layout.left = left;
+    layout.top = top;
+    layout.right = right;
+    layout.bottom = bottom;
+    layout.thresholds = thresholds;
+
+    layout.aoaMin = std::floor(thresholds.belowLDMax - AOA_TAPE_MARGIN_BELOW);
+    layout.aoaMax = std::ceil(thresholds.aboveOnSpeedMax + AOA_TAPE_MARGIN_ABOVE);
+
+    float width = (right - left) / 3.0f;
+    layout.tapeLeft = left + TAPE_PADDING;
+    layout.tapeRight = layout.tapeLeft + (width < TAPE_WIDTH_MAX ? width : TAPE_WIDTH_MAX);
+    layout.tapeBottom = bottom + TAPE_PADDING;
+    layout.tapeTop = top - TAPE_PADDING;
+    if (layout.tapeTop <= layout.tapeBottom) {
+        layout.tapeTop = layout.tapeBottom + 1.0f;    // window too small to show anything, keep aoaToY finite
+    }
+
+    const float edges[AOA_TAPE_BANDS + 1] = {layout.aoaMin, thresholds.belowLDMax, thresholds.belowOnSpeed,
+                                             thresholds.onSpeedMax, thresholds.aboveOnSpeedMax, layout.aoaMax};
+    const ToneZone zones[AOA_TAPE_BANDS] = {ToneZone::BelowLDMax, ToneZone::BelowOnSpeed, ToneZone::OnSpeed,
+                                            ToneZone::AboveOnSpeed, ToneZone::Stall};
+    for (int i = 0; i < AOA_TAPE_BANDS; i++) {
+        layout.bands[i] = AoaTapeBand{zones[i], layout.aoaToY(edges[i]), layout.aoaToY(edges[i + 1])};
+    }
+
+    // Label every degree if there is room, otherwise every 2 or 5
+    float pixelsPerDegree = (layout.tapeTop - layout.tapeBottom) / (layout.aoaMax - layout.aoaMin);
+    int step = pixelsPerDegree >= TICK_SPACING_MIN ? 1 : pixelsPerDegree * 2 >= TICK_SPACING_MIN ? 2 : 5;
+    layout.tickCount = 0;
+    for (int degrees = static_cast<int>(std::ceil(layout.aoaMin / step)) * step;
+         degrees <= layout.aoaMax && layout.tickCount < AOA_TAPE_TICKS_MAX; degrees += step) {
+        AoaTapeTick& tick = layout.ticks[layout.tickCount++];
+        tick.y = layout.aoaToY(static_cast<float>(degrees));
+        snprintf(tick.label, sizeof(tick.label), "%d", degrees);
+    }
+}
+
+bool isAoaTapeLayoutFor(const AoaTapeLayout& layout, int left, int top, int right, int bottom,
+                        const AoaThresholds& thresholds) {
+    const AoaThresholds& t = layout.thresholds;
+    return layout.left == left && layout.top == top && layout.right == right && layout.bottom == bottom &&
+           t.belowLDMax == thresholds.belowLDMax && t.belowOnSpeed == thresholds.belowOnSpeed &&
+           t.onSpeedMax == thresholds.onSpeedMax && t.aboveOnSpeedMax == thresholds.aboveOnSpeedMax;
+}
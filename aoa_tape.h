@@ -0,0 +1,61 @@
+#ifndef AOA_TAPE_H
+#define AOA_TAPE_H
+
+#include "aoa_engine.h"
+
+#define AOA_TAPE_BANDS          5       // Below L/DMax, below OnSpeed, OnSpeed, above OnSpeed, stall warning
+#define AOA_TAPE_TICKS_MAX      32
+#define AOA_TAPE_MARGIN_BELOW   3.0f    // Degrees shown below L/DMax
+#define AOA_TAPE_MARGIN_ABOVE   3.0f    // Degrees shown above the stall warning
+
+// One zone's stretch of the tape, in window pixels
+struct AoaTapeBand {
+    ToneZone zone;
+    float bottom;
+    float top;
+};
+
+struct AoaTapeTick {
+    float y;
+    char label[8];          // whole degrees, "12"
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Geometry of a vertical AOA tape: where each zone band and degree tick goes for a window rectangle and a set
+// of setpoints. It only changes when the window is moved or resized or the setpoints change, so it is worked
+// out once by layoutAoaTape() and reused for every draw. Pixels are X-Plane window coordinates, y up.
+struct AoaTapeLayout {
+    // What the layout was made for, compared by isAoaTapeLayoutFor()
+    int left, top, right, bottom;
+    AoaThresholds thresholds;
+
+    float aoaMin;           // degrees at the bottom of the tape
+    float aoaMax;           // degrees at the top
+    float tapeLeft;
+    float tapeRight;
+    float tapeBottom;
+    float tapeTop;
+
+    AoaTapeBand bands[AOA_TAPE_BANDS];
+    AoaTapeTick ticks[AOA_TAPE_TICKS_MAX];
+    int tickCount;
+
+    // Pixel height of an AOA, clamped to the ends of the tape
+    float aoaToY(float aoa) const {
+        float y = tapeBottom + (aoa - aoaMin) * (tapeTop - tapeBottom) / (aoaMax - aoaMin);
+        return y < tapeBottom ? tapeBottom : y > tapeTop ? tapeTop : y;
+    }
+};
+
+// RGBA colour of a zone's band, shared by the tape and the scope. BelowIAS is transparent.
+const float* toneZoneColor(ToneZone zone);
+
+// Lay out a tape in the left part of the rectangle, leaving the right for the readout text
+void layoutAoaTape(AoaTapeLayout& layout, int left, int top, int right, int bottom, const AoaThresholds& thresholds);
+
+// True if layout was made for this rectangle and these setpoints
+bool isAoaTapeLayoutFor(const AoaTapeLayout& layout, int left, int top, int right, int bottom,
+                        const AoaThresholds& thresholds);
+
+#endif // AOA_TAPE_H
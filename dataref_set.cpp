@@ -0,0 +1,107 @@
+#include "dataref_set.h"
+#include "logger.h"
+
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+DataRefSet::DataRefSet(const DataRefSpec* specs, int count)
+    : specs(specs),
+      specCount(count < DATAREF_SET_MAX ? count : DATAREF_SET_MAX) {
+    for (int i = 0; i < DATAREF_SET_MAX; i++) {
+        entries[i].ref = nullptr;
+        entries[i].readAs = xplmType_Unknown;
+        entries[i].status = Status::Unresolved;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool DataRefSet::resolve() {
+    bool ok = true;
+
+    for (int i = 0; i < specCount; i++) {
+        const DataRefSpec& spec = specs[i];
+        Entry& entry = entries[i];
+        entry.ref = nullptr;
+        entry.readAs = xplmType_Unknown;
+
+        Status lastStatus = entry.status;
+
+        XPLMDataRef ref = XPLMFindDataRef(spec.name);
+        if (ref == nullptr) {
+            entry.status = Status::Missing;
+            if (lastStatus != Status::Missing) {
+                LOG_WARNING("Failed to find DataRef %s", spec.name);
+            }
+            ok = ok && !spec.required;
+            continue;
+        }
+
+        // Pick the most precise type the dataref offers that fits the snapshot
+        XPLMDataTypeID types = XPLMGetDataRefTypes(ref);
+        if (spec.kind == DataRefKind::FloatArray) {
+            if (types & xplmType_FloatArray) entry.readAs = xplmType_FloatArray;
+        } else if (types & xplmType_Float) {
+            entry.readAs = xplmType_Float;
+        } else if (types & xplmType_Double) {
+            entry.readAs = xplmType_Double;
+        } else if (types & xplmType_Int) {
+            entry.readAs = xplmType_Int;
+        }
+
+        if (entry.readAs == xplmType_Unknown) {
+            entry.status = Status::UnusableType;
+            if (lastStatus != Status::UnusableType) {
+                LOG_WARNING("DataRef %s has unusable type %d", spec.name, types);
+            }
+            ok = ok && !spec.required;
+            continue;
+        }
+
+        entry.ref = ref;
+        entry.status = Status::Found;
+        if (lastStatus == Status::Missing || lastStatus == Status::UnusableType) {
+            LOG_INFO("DataRef %s is now available", spec.name);
+        }
+    }
+
+    return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DataRefSet::read(void* snapshot) const {
+    char* base = static_cast<char*>(snapshot);
+
+    for (int i = 0; i < specCount; i++) {
+        const DataRefSpec& spec = specs[i];
+        const Entry& entry = entries[i];
+        float* out = reinterpret_cast<float*>(base + spec.offset);
+
+        switch (entry.readAs) {
+            case xplmType_Float:
+                *out = XPLMGetDataf(entry.ref);
+                break;
+            case xplmType_Double:
+                *out = static_cast<float>(XPLMGetDatad(entry.ref));
+                break;
+            case xplmType_Int:
+                *out = static_cast<float>(XPLMGetDatai(entry.ref));
+                break;
+            case xplmType_FloatArray: {
+                // Zero anything past the end of a short array
+                int got = XPLMGetDatavf(entry.ref, out, spec.arrayOffset, spec.count);
+                for (int j = got < 0 ? 0 : got; j < spec.count; j++) {
+                    out[j] = 0.0f;
+                }
+                break;
+            }
+            default:
+                for (int j = 0; j < spec.count; j++) {
+                    out[j] = 0.0f;
+                }
+                break;
+        }
+    }
+}
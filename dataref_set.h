@@ -0,0 +1,69 @@
+#ifndef DATAREF_SET_H
+#define DATAREF_SET_H
+
+#include "SDK/CHeaders/XPLM/XPLMDataAccess.h"
+
+#include <cstddef>
+
+#define DATAREF_SET_MAX        32      // Most datarefs a single set can hold
+
+enum class DataRefKind {
+    Scalar,         // int, float or double dataref read into one float
+    FloatArray      // float array dataref read into count consecutive floats
+};
+
+// One dataref and where its value lands in the snapshot struct
+struct DataRefSpec {
+    const char* name;
+    size_t offset;          // offsetof() the float field in the snapshot
+    DataRefKind kind;
+    int count;              // number of floats for FloatArray, 1 for Scalar
+    int arrayOffset;        // first array element to read for FloatArray
+    bool required;          // resolve() fails if this one is missing or the wrong type
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A declared list of datarefs that are looked up once and then read together into a snapshot struct.
+// The spec table must outlive the set. Every snapshot field is a float; scalars of other types are converted.
+// Call resolve() at start and again whenever the sim might have changed the datarefs (plane loaded,
+// datarefs added). Call read() once per frame and share the snapshot instead of calling the XPLM again.
+class DataRefSet {
+public:
+    DataRefSet(const DataRefSpec* specs, int count);
+
+    // Look up every dataref and check its type. Returns false if a required one is unusable.
+    // A missing or unusable dataref is logged the first time, and again only if that changes, since the sim
+    // calls for another resolve() every time any plugin adds datarefs.
+    bool resolve();
+
+    // Read every resolved dataref into the snapshot. Unresolved fields are set to 0.
+    void read(void* snapshot) const;
+
+    template <typename Snapshot>
+    void read(Snapshot& snapshot) const { read(static_cast<void*>(&snapshot)); }
+
+    bool isResolved(int index) const { return index >= 0 && index < specCount && entries[index].ref != nullptr; }
+    int size() const { return specCount; }
+    const DataRefSpec& spec(int index) const { return specs[index]; }
+
+private:
+    enum class Status {
+        Unresolved,         // resolve() hasn't looked at it yet
+        Found,
+        Missing,
+        UnusableType
+    };
+
+    struct Entry {
+        XPLMDataRef ref;
+        XPLMDataTypeID readAs;      // the single type we read it as
+        Status status;              // as of the last resolve(), to log only changes
+    };
+
+    const DataRefSpec* specs;
+    int specCount;
+    Entry entries[DATAREF_SET_MAX];
+};
+
+#endif // DATAREF_SET_H
@@ -0,0 +1,196 @@
+#include "file_watcher.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+struct FileState {
+    bool exists;
+    long long size;
+    long long modified;
+
+    bool operator!=(const FileState& other) const {
+        return exists != other.exists || size != other.size || modified != other.modified;
+    }
+};
+
+FileState statFile(const char* path) {
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        return FileState{false, 0, 0};
+    }
+    return FileState{true, static_cast<long long>(info.st_size), static_cast<long long>(info.st_mtime)};
+}
+
+#ifdef __linux__
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Wait for inotify events on the folder until the wake pipe is written. Sets changed when one names the file.
+void waitForEvents(int inotifyFd, int wakeFd, const char* name, std::atomic<bool>& changed) {
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    alignas(inotify_event) char buffer[4096];
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (fds[1].revents) {
+            while (read(wakeFd, buffer, sizeof(buffer)) > 0) {
+            }
+            return;
+        }
+
+        ssize_t length;
+        while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length; ) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                if (event->len && !strcmp(event->name, name)) {
+                    changed.store(true, std::memory_order_release);
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
+#endif
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FileWatcher::FileWatcher()
+    : running(false),
+      pathChanged(false),
+      wakePipe{-1, -1},
+      changed(false),
+      polling(false) {
+    path[0] = '\0';
+}
+
+FileWatcher::~FileWatcher() {
+    stop();
+#ifdef __linux__
+    if (wakePipe[0] >= 0) {
+        close(wakePipe[0]);
+        close(wakePipe[1]);
+    }
+#endif
+}
+
+void FileWatcher::watch(const char* newPath) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        snprintf(path, sizeof(path), "%s", newPath);
+        pathChanged = true;
+        if (!running) {
+#ifdef __linux__
+            if (wakePipe[0] < 0 && pipe2(wakePipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+                wakePipe[0] = wakePipe[1] = -1;
+            }
+#endif
+            running = true;
+            worker = std::thread(&FileWatcher::threadFunction, this);
+        }
+    }
+    changed.store(false, std::memory_order_relaxed);
+    wake();
+}
+
+void FileWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wake();
+    worker.join();
+}
+
+void FileWatcher::wake() {
+#ifdef __linux__
+    if (wakePipe[1] >= 0) {
+        char byte = 1;
+        if (write(wakePipe[1], &byte, 1) < 0) {
+            // Pipe full, the thread has wake ups waiting already
+        }
+    }
+#endif
+    wakeCondition.notify_all();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// One pass of the outer loop per watched path. inotify is set up on the file's folder, since editors often
+// replace the file rather than write to it; if that can't be done the file is polled instead.
+void FileWatcher::threadFunction() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        char watched[FILE_WATCH_PATH_MAX];
+        snprintf(watched, sizeof(watched), "%s", path);
+        pathChanged = false;
+        lock.unlock();
+
+#ifdef __linux__
+        char directory[FILE_WATCH_PATH_MAX];
+        snprintf(directory, sizeof(directory), "%s", watched);
+        char* slash = strrchr(directory, '/');
+        const char* name = slash ? slash + 1 : watched;
+        if (slash) {
+            *slash = '\0';
+        } else {
+            snprintf(directory, sizeof(directory), ".");
+        }
+
+        int inotifyFd = wakePipe[0] >= 0 ? inotify_init1(IN_NONBLOCK | IN_CLOEXEC) : -1;
+        if (inotifyFd >= 0 && inotify_add_watch(inotifyFd, directory,
+                                                IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM) >= 0) {
+            polling.store(false, std::memory_order_relaxed);
+            waitForEvents(inotifyFd, wakePipe[0], name, changed);
+            close(inotifyFd);
+            lock.lock();
+            continue;
+        }
+        if (inotifyFd >= 0) {
+            close(inotifyFd);
+        }
+#endif
+
+        // Polling fallback. On Linux this only runs until the file shows up, then inotify is tried again.
+        polling.store(true, std::memory_order_relaxed);
+        FileState last = statFile(watched);
+        lock.lock();
+        while (running && !pathChanged) {
+            wakeCondition.wait_for(lock, std::chrono::milliseconds(FILE_WATCH_POLL_MS));
+            if (!running || pathChanged) {
+                break;
+            }
+            lock.unlock();
+            FileState now = statFile(watched);
+            lock.lock();
+            if (now != last) {
+                last = now;
+                changed.store(true, std::memory_order_release);
+#ifdef __linux__
+                break;
+#endif
+            }
+        }
+    }
+}
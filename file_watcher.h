@@ -0,0 +1,50 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define FILE_WATCH_PATH_MAX     512
+#define FILE_WATCH_POLL_MS      1000    // How often the polling fallback looks at the file
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Watches one file for changes made outside the plugin, on its own thread.
+// On Linux it waits on inotify for writes, deletes and renames into or out of the file's folder, so editors that
+// save to a temporary file and rename it are seen too. Elsewhere, or when the folder doesn't exist yet, it falls back to
+// checking the file's size and modification time every FILE_WATCH_POLL_MS. Changes only set a flag; the sim
+// thread picks it up with takeChanged(), so several writes in one frame count once.
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    // Watch path instead of whatever was watched before. Starts the thread the first time.
+    void watch(const char* path);
+
+    void stop();
+
+    // True, once, if the file was written, replaced or removed since the last call
+    bool takeChanged() { return changed.exchange(false, std::memory_order_acquire); }
+
+    bool isPolling() const { return polling.load(std::memory_order_relaxed); }
+
+private:
+    void threadFunction();
+    void wake();
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    bool running;
+    bool pathChanged;                   // guarded by mutex, watch() was called
+    char path[FILE_WATCH_PATH_MAX];     // guarded by mutex
+    int wakePipe[2];                    // Linux, lets stop() and watch() interrupt the inotify wait
+
+    std::atomic<bool> changed;
+    std::atomic<bool> polling;
+};
+
+#endif // FILE_WATCHER_H
@@ -0,0 +1,230 @@
+#include "flight_recorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FlightRecorder::FlightRecorder()
+    : header(nullptr),
+      records(nullptr),
+      recordCapacity(0),
+      mappedBytes(0),
+      recordCount(0),
+      droppedCount(0),
+#ifdef _WIN32
+      fileHandle(INVALID_HANDLE_VALUE),
+      mappingHandle(nullptr),
+#else
+      fd(-1),
+#endif
+      syncRunning(false) {
+    filePath[0] = '\0';
+}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+    wait();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Size the file for capacity records up front so appending never has to grow it
+bool FlightRecorder::open(const char* path, uint64_t capacity) {
+    close();
+    wait();
+    if (capacity == 0) {
+        return false;
+    }
+    size_t bytes = sizeof(FlightRecordHeader) + capacity * sizeof(FlightRecord);
+    void* mapping = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(bytes >> 32),
+                                            static_cast<DWORD>(bytes & 0xFFFFFFFF), nullptr);
+    if (fileMapping) {
+        mapping = MapViewOfFile(fileMapping, FILE_MAP_WRITE, 0, 0, bytes);
+    }
+    if (!mapping) {
+        if (fileMapping) {
+            CloseHandle(fileMapping);
+        }
+        CloseHandle(file);
+        DeleteFileA(path);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = fileMapping;
+#else
+    int file = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return false;
+    }
+    // Reserve the blocks now, not on first touch from the sim thread. macOS has no posix_fallocate.
+#if defined(__APPLE__)
+    bool sized = ftruncate(file, static_cast<off_t>(bytes)) == 0;
+#else
+    bool sized = posix_fallocate(file, 0, static_cast<off_t>(bytes)) == 0;
+#endif
+    if (sized) {
+        mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+        }
+    }
+    if (!mapping) {
+        ::close(file);
+        unlink(path);
+        return false;
+    }
+    fd = file;
+#endif
+
+    snprintf(filePath, sizeof(filePath), "%s", path);
+    mappedBytes = bytes;
+    header = static_cast<FlightRecordHeader*>(mapping);
+    records = reinterpret_cast<FlightRecord*>(header + 1);
+    recordCapacity = capacity;
+    recordCount.store(0, std::memory_order_relaxed);
+    droppedCount = 0;
+
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, FLIGHT_RECORD_MAGIC, sizeof(header->magic));
+    header->version = FLIGHT_RECORD_VERSION;
+    header->recordSize = sizeof(FlightRecord);
+    header->capacity = capacity;
+    header->startUnixTime = static_cast<int64_t>(time(nullptr));
+
+    syncRunning = true;
+    syncThread = std::thread(&FlightRecorder::syncThreadFunction, this);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Stop appending and leave the sync thread to finish the file off
+void FlightRecorder::close() {
+    if (!isOpen()) {
+        return;
+    }
+    records = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(syncMutex);
+        syncRunning = false;
+    }
+    syncWake.notify_all();
+}
+
+void FlightRecorder::wait() {
+    if (syncThread.joinable()) {
+        syncThread.join();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Flush everything, then trim the unused preallocated tail so the file is just header plus records. Runs on the
+// sync thread once the recording is closed.
+void FlightRecorder::finish() {
+    sync(true);
+    uint64_t used = sizeof(FlightRecordHeader) + recordCount.load(std::memory_order_relaxed) * sizeof(FlightRecord);
+
+#ifdef _WIN32
+    UnmapViewOfFile(header);
+    CloseHandle(mappingHandle);
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(used);
+    if (SetFilePointerEx(fileHandle, size, nullptr, FILE_BEGIN)) {
+        SetEndOfFile(fileHandle);
+    }
+    CloseHandle(fileHandle);
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+#else
+    munmap(header, mappedBytes);
+    if (ftruncate(fd, static_cast<off_t>(used)) != 0) {
+        // The header count still says how many records are valid
+    }
+    ::close(fd);
+    fd = -1;
+#endif
+
+    header = nullptr;
+    mappedBytes = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Publish the count in the header and push dirty pages to disk. The records up to count were written before
+// the release store that made count visible, so the header never claims a record that isn't there.
+void FlightRecorder::sync(bool wait) {
+    header->count = recordCount.load(std::memory_order_acquire);
+#ifdef _WIN32
+    FlushViewOfFile(header, mappedBytes);
+    if (wait) {
+        FlushFileBuffers(fileHandle);
+    }
+#else
+    msync(header, mappedBytes, wait ? MS_SYNC : MS_ASYNC);
+#endif
+}
+
+void FlightRecorder::syncThreadFunction() {
+    {
+        std::unique_lock<std::mutex> lock(syncMutex);
+        while (syncRunning) {
+            syncWake.wait_for(lock, std::chrono::milliseconds(FLIGHT_RECORDER_SYNC_MS),
+                              [this] { return !syncRunning; });
+            if (syncRunning) {
+                sync(false);
+            }
+        }
+    }
+    finish();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool loadFlightRecording(const char* path, std::vector<FlightRecord>& records, FlightRecordHeader* headerOut) {
+    records.clear();
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    FlightRecordHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, FLIGHT_RECORD_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FLIGHT_RECORD_VERSION || header.recordSize != sizeof(FlightRecord) ||
+        header.count > header.capacity) {
+        fclose(file);
+        return false;
+    }
+
+    records.resize(static_cast<size_t>(header.count));
+    size_t read = records.empty() ? 0 : fread(records.data(), sizeof(FlightRecord), records.size(), file);
+    records.resize(read);
+    fclose(file);
+
+    if (headerOut) {
+        *headerOut = header;
+        headerOut->count = read;
+    }
+    return true;
+}
@@ -0,0 +1,119 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define FLIGHT_RECORD_MAGIC             "FOSREC1"   // 8 bytes with the terminator
+#define FLIGHT_RECORD_VERSION           1
+#define FLIGHT_RECORDER_CAPACITY        (2 * 3600 * 60)     // Records per file, two hours at 60 fps (about 17 MB)
+#define FLIGHT_RECORDER_SYNC_MS         1000                // How often the background thread msyncs
+
+// FlightRecord::flags
+#define FLIGHT_RECORD_SPIKE             0x01    // the raw sample was rejected by the spike filter
+#define FLIGHT_RECORD_AUDIO_ENABLED     0x02    // the Sound button was on
+
+// One processed frame. Fixed size and little endian as written by the host, so a file is just
+// a FlightRecordHeader followed by count of these.
+struct FlightRecord {
+    double time;            // seconds since recording started, the flight loop's elapsed times summed: wall
+                            // time, so it runs on through a sim pause like the pulse thread does
+    float rawAoa;           // degrees, the dataref value before the spike filter
+    float avgAoa;           // degrees, after the spike filter and moving average
+    float ias;              // knots
+    float gLoad;            // normal load factor
+    float flapRatio;        // 0 up to 1 full
+    float pulseRate;        // pulses per second, 0 when silent or steady
+    float frequency;        // Hz, 0 when silent
+    uint8_t zone;           // ToneZone
+    uint8_t flags;          // FLIGHT_RECORD_*
+    uint16_t reserved;
+};
+static_assert(sizeof(FlightRecord) == 40, "FlightRecord is a file format");
+
+struct FlightRecordHeader {
+    char magic[8];              // FLIGHT_RECORD_MAGIC
+    uint32_t version;           // FLIGHT_RECORD_VERSION
+    uint32_t recordSize;        // sizeof(FlightRecord)
+    uint64_t capacity;          // records the file was sized for
+    uint64_t count;             // records written, as of the last sync
+    int64_t startUnixTime;      // wall clock seconds when recording started
+    uint8_t reserved[24];
+};
+static_assert(sizeof(FlightRecordHeader) == 64, "FlightRecordHeader is a file format");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Flight data recorder for debriefing approaches and reproducing field reports.
+// open() preallocates the whole file and maps it, so append() is a struct copy into the mapping and a relaxed
+// counter bump, with no syscall and no allocation on the sim thread. A background thread writes the record
+// count into the header and msyncs every FLIGHT_RECORDER_SYNC_MS, so a crash loses at most that much.
+// close() only stops appending; the background thread then flushes the file, trims it to the records actually
+// written and exits, so stopping a recording costs the sim thread nothing. append(), open(), close() and wait()
+// must be called from the same thread.
+class FlightRecorder {
+public:
+    FlightRecorder();
+    ~FlightRecorder();
+
+    // Waits for the last recording to be finished off first
+    bool open(const char* path, uint64_t capacity = FLIGHT_RECORDER_CAPACITY);
+    void close();
+
+    // Wait for a closed recording to be flushed and trimmed. Call before the plugin unloads.
+    void wait();
+
+    bool isOpen() const { return records != nullptr; }
+
+    // Drops the record once the file is full
+    void append(const FlightRecord& record) {
+        uint64_t index = recordCount.load(std::memory_order_relaxed);
+        if (index >= recordCapacity) {
+            droppedCount++;
+            return;
+        }
+        records[index] = record;
+        recordCount.store(index + 1, std::memory_order_release);
+    }
+
+    uint64_t count() const { return recordCount.load(std::memory_order_relaxed); }
+    uint64_t capacity() const { return recordCapacity; }
+    uint64_t dropped() const { return droppedCount; }
+    const char* path() const { return filePath; }
+
+private:
+    void syncThreadFunction();
+    void sync(bool wait);
+    void finish();
+
+    // The mapping and file belong to the sync thread from close() until it exits
+    char filePath[512];
+    FlightRecordHeader* header;     // start of the mapping
+    FlightRecord* records;          // right after the header
+    uint64_t recordCapacity;
+    size_t mappedBytes;
+    std::atomic<uint64_t> recordCount;
+    uint64_t droppedCount;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+
+    std::thread syncThread;
+    std::mutex syncMutex;
+    std::condition_variable syncWake;
+    bool syncRunning;
+};
+
+// Read a recording made by FlightRecorder, up to the count in its header. A file from a crashed session
+// keeps what was synced. Returns false if the file isn't a recording this build understands.
+bool loadFlightRecording(const char* path, std::vector<FlightRecord>& records, FlightRecordHeader* header = nullptr);
+
+#endif // FLIGHT_RECORDER_H
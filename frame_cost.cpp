@@ -0,0 +1,123 @@
+#include "frame_cost.h"
+
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static int log2Floor(uint64_t value) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bits = 0;
+    while (value >>= 1) {
+        bits++;
+    }
+    return bits;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void FrameCostHistogram::reset() {
+    memset(counts, 0, sizeof(counts));
+    total = 0;
+    sum = 0;
+    minValue = INT64_MAX;
+    maxValue = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void FrameCostHistogram::add(int64_t ns) {
+    if (ns < 0) {
+        ns = 0;
+    }
+    counts[bucketOf(ns)]++;
+    total++;
+    sum += ns;
+    if (ns < minValue) minValue = ns;
+    if (ns > maxValue) maxValue = ns;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int64_t FrameCostHistogram::percentileNs(double fraction) const {
+    if (total == 0) {
+        return 0;
+    }
+
+    long long rank = static_cast<long long>(fraction * total);
+    if (rank >= total) {
+        rank = total - 1;
+    }
+
+    long long seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += counts[i];
+        if (seen > rank) {
+            int64_t edge = bucketUpperEdge(i);
+            return edge < maxValue ? edge : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Values below 8 get a bucket each, above that 8 buckets per power of two
+int FrameCostHistogram::bucketOf(int64_t ns) {
+    if (ns < SUB_BUCKETS) {
+        return static_cast<int>(ns);
+    }
+    int exponent = log2Floor(static_cast<uint64_t>(ns));
+    int sub = static_cast<int>(ns >> (exponent - 3)) - SUB_BUCKETS;
+    int bucket = SUB_BUCKETS + (exponent - 3) * SUB_BUCKETS + sub;
+    return bucket < BUCKETS ? bucket : BUCKETS - 1;
+}
+
+int64_t FrameCostHistogram::bucketUpperEdge(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    int exponent = (bucket - SUB_BUCKETS) / SUB_BUCKETS + 3;
+    int sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return (static_cast<int64_t>(SUB_BUCKETS + sub + 1) << (exponent - 3)) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FrameCostStats::FrameCostStats() {
+    reset();
+}
+
+void FrameCostStats::reset() {
+    window.reset();
+    windowSeconds = 0.0f;
+    overBudget = 0;
+    last = FrameCostSummary{0.0f, 0.0f, 0.0f, 0.0f, 0, 0};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool FrameCostStats::add(int64_t ns, float elapsed) {
+    window.add(ns);
+    if (ns > static_cast<int64_t>(FRAME_COST_BUDGET_US * 1000.0f)) {
+        overBudget++;
+    }
+
+    windowSeconds += elapsed;
+    if (windowSeconds < FRAME_COST_WINDOW_SECONDS) {
+        return false;
+    }
+
+    last.minUs = window.minNs() / 1000.0f;
+    last.meanUs = static_cast<float>(window.meanNs() / 1000.0);
+    last.p99Us = window.percentileNs(0.99) / 1000.0f;
+    last.maxUs = window.maxNs() / 1000.0f;
+    last.frames = window.count();
+    last.overBudget = overBudget;
+
+    window.reset();
+    windowSeconds = 0.0f;
+    return true;
+}
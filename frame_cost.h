@@ -0,0 +1,77 @@
+#ifndef FRAME_COST_H
+#define FRAME_COST_H
+
+#include <cstdint>
+
+#define FRAME_COST_BUDGET_US        20.0f   // What one flight loop call of this plugin may cost
+#define FRAME_COST_WINDOW_SECONDS   5.0f    // Stats are reported over windows this long
+
+// Min/mean/p99/max over one window, in microseconds
+struct FrameCostSummary {
+    float minUs;
+    float meanUs;
+    float p99Us;
+    float maxUs;
+    long long frames;           // frames in the window
+    long long overBudget;       // frames over FRAME_COST_BUDGET_US since start
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fixed-size log-linear histogram of durations in nanoseconds.
+// Each power of two is split into 8 buckets, so a percentile is within 12.5% of the true value. add() is a
+// handful of integer ops and never allocates.
+class FrameCostHistogram {
+public:
+    FrameCostHistogram() { reset(); }
+
+    void reset();
+    void add(int64_t ns);
+
+    long long count() const { return total; }
+    int64_t minNs() const { return total ? minValue : 0; }
+    int64_t maxNs() const { return maxValue; }
+    double meanNs() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    // Upper edge of the bucket holding the given fraction of samples, clamped to the max seen
+    int64_t percentileNs(double fraction) const;
+
+private:
+    static const int SUB_BUCKETS = 8;
+    static const int BUCKETS = SUB_BUCKETS * 41;    // up to 2^43 ns, over two hours
+
+    static int bucketOf(int64_t ns);
+    static int64_t bucketUpperEdge(int bucket);
+
+    uint32_t counts[BUCKETS];
+    long long total;
+    int64_t sum;
+    int64_t minValue;
+    int64_t maxValue;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Per-frame cost of the flight loop callback, summarized every FRAME_COST_WINDOW_SECONDS.
+// The histogram is cleared at each window so a regression shows up in the next summary instead of being
+// averaged into the whole session.
+class FrameCostStats {
+public:
+    FrameCostStats();
+
+    void reset();
+
+    // Record one call. Returns true when a window closed and summary() has new numbers.
+    bool add(int64_t ns, float elapsed);
+
+    // The last closed window
+    const FrameCostSummary& summary() const { return last; }
+
+private:
+    FrameCostHistogram window;
+    float windowSeconds;
+    long long overBudget;
+    FrameCostSummary last;
+};
+
+#endif // FRAME_COST_H
@@ -0,0 +1,146 @@
+#include "logger.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+AsyncLogger::AsyncLogger()
+    : enqueuePos(0),
+      dequeuePos(0),
+      logSink(nullptr),
+      linePrefix(""),
+      minLevel(LogLevel::Debug),
+      running(false),
+      droppedCount(0),
+      droppedReported(0) {
+    for (unsigned i = 0; i < LOG_RING_SIZE; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AsyncLogger::start(LogSink sink, const char* prefix) {
+    if (running) {
+        return;
+    }
+    logSink = sink;
+    linePrefix = prefix ? prefix : "";
+    running.store(true, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AsyncLogger::flush() {
+    if (running.load(std::memory_order_relaxed)) {
+        drain();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AsyncLogger::stop() {
+    if (!running) {
+        return;
+    }
+    running.store(false, std::memory_order_release);
+    drain();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AsyncLogger::write(LogLevel level, const char* format, ...) {
+    if (!enabled(level)) {
+        return;
+    }
+
+    char direct[LOG_MESSAGE_MAX];
+    char* text = direct;
+    unsigned pos = 0;
+    Slot* slot = nullptr;
+
+    if (running.load(std::memory_order_acquire)) {
+        // Claim a slot: its sequence equals our position when it is free for this lap of the ring
+        pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots[pos & (LOG_RING_SIZE - 1)];
+            int diff = static_cast<int>(slot->sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        text = slot->text;
+    }
+
+    int used = snprintf(text, LOG_MESSAGE_MAX, "%s", linePrefix);
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text + used, LOG_MESSAGE_MAX - used, format, args);
+    va_end(args);
+    used = length < 0 ? used : (used + length < LOG_MESSAGE_MAX - 1 ? used + length : LOG_MESSAGE_MAX - 2);
+    if (used == 0 || text[used - 1] != '\n') {
+        text[used] = '\n';
+        text[used + 1] = '\0';
+    }
+
+    if (slot) {
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    } else if (logSink) {
+        logSink(text);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copy finished messages into a batch and pass each full batch to the sink in one call
+void AsyncLogger::drain() {
+    char batch[4096];
+    size_t batchUsed = 0;
+    batch[0] = '\0';
+
+    for (;;) {
+        Slot& slot = slots[dequeuePos & (LOG_RING_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;      // empty, or the writer is still formatting
+        }
+
+        size_t length = strlen(slot.text);
+        if (batchUsed + length >= sizeof(batch)) {
+            if (logSink) logSink(batch);
+            batchUsed = 0;
+            batch[0] = '\0';
+        }
+        memcpy(batch + batchUsed, slot.text, length + 1);
+        batchUsed += length;
+
+        slot.sequence.store(dequeuePos + LOG_RING_SIZE, std::memory_order_release);
+        dequeuePos++;
+    }
+
+    long long droppedNow = droppedCount.load(std::memory_order_relaxed);
+    if (droppedNow != droppedReported && batchUsed + LOG_MESSAGE_MAX < sizeof(batch)) {
+        batchUsed += snprintf(batch + batchUsed, sizeof(batch) - batchUsed, "%s%lld log messages dropped\n",
+                              linePrefix, droppedNow - droppedReported);
+        droppedReported = droppedNow;
+    }
+
+    if (batchUsed > 0 && logSink) {
+        logSink(batch);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+AsyncLogger& pluginLog() {
+    static AsyncLogger logger;
+    return logger;
+}
@@ -0,0 +1,88 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+
+#define LOG_RING_SIZE           256     // Messages that can wait for the flush thread, a power of two
+#define LOG_MESSAGE_MAX         256     // Longest message, longer ones are cut
+#define LOG_FLUSH_INTERVAL_MS   50      // How often the owner should call flush()
+
+enum class LogLevel {
+    Debug,          // chatter for development, compiled out of release builds
+    Info,
+    Warning,
+    Error
+};
+
+// Where flushed text goes, e.g. XPLMDebugString
+typedef void (*LogSink)(const char* text);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Leveled logger that never blocks the caller.
+// write() formats straight into a slot of a fixed lock-free ring (any number of writer threads) and returns.
+// The sim thread calls flush() every LOG_FLUSH_INTERVAL_MS from a flight loop callback, which hands the text to
+// the sink in batches, so Log.txt is written a few times a second at most instead of once per message and the
+// sink, XPLMDebugString, is only ever called from the sim thread.
+// If the ring is full the message is dropped and counted; the count is logged with the next batch.
+// Before start() and after stop() write() goes straight to the sink on the calling thread.
+class AsyncLogger {
+public:
+    AsyncLogger();
+    ~AsyncLogger() { stop(); }
+
+    // prefix goes in front of every line, e.g. "FlyOnSpeed: "
+    void start(LogSink sink, const char* prefix);
+
+    // Hand queued messages to the sink. Only ever from one thread, the one that called start().
+    void flush();
+
+    // Flush whatever is left and go back to writing straight to the sink
+    void stop();
+
+    void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+
+    // printf style, a newline is added if missing
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    void write(LogLevel level, const char* format, ...);
+
+    long long dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<unsigned> sequence;
+        char text[LOG_MESSAGE_MAX];
+    };
+
+    void drain();
+
+    Slot slots[LOG_RING_SIZE];
+    std::atomic<unsigned> enqueuePos;
+    unsigned dequeuePos;                    // only flush() and stop() touch this
+
+    LogSink logSink;
+    const char* linePrefix;
+    std::atomic<LogLevel> minLevel;
+    std::atomic<bool> running;
+    std::atomic<long long> droppedCount;
+    long long droppedReported;
+};
+
+// The plugin's logger
+AsyncLogger& pluginLog();
+
+#define LOG_INFO(...)       pluginLog().write(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...)    pluginLog().write(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...)      pluginLog().write(LogLevel::Error, __VA_ARGS__)
+
+// Debug messages and their arguments disappear from release builds
+#ifdef NDEBUG
+#define LOG_DEBUG(...)      ((void)0)
+#else
+#define LOG_DEBUG(...)      pluginLog().write(LogLevel::Debug, __VA_ARGS__)
+#endif
+
+#endif // LOGGER_H
@@ -0,0 +1,37 @@
+#include "metrics.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+MetricsRegistry::MetricsRegistry()
+    : metricCount(0) {
+    reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int MetricsRegistry::addCounter(const char* name, const char* label) {
+    return add(name, label, MetricKind::Counter);
+}
+
+int MetricsRegistry::addGauge(const char* name, const char* label) {
+    return add(name, label, MetricKind::Gauge);
+}
+
+int MetricsRegistry::add(const char* name, const char* label, MetricKind kind) {
+    if (metricCount >= METRICS_MAX) {
+        return -1;
+    }
+    names[metricCount] = name;
+    labels[metricCount] = label;
+    kinds[metricCount] = kind;
+    return metricCount++;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistry::reset() {
+    for (int i = 0; i < METRICS_MAX; i++) {
+        counters[i].store(0, std::memory_order_relaxed);
+        gauges[i].store(0.0f, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+
+#define METRICS_MAX     32      // Most metrics one registry holds
+
+enum class MetricKind {
+    Counter,            // only goes up, e.g. frames processed
+    Gauge               // last value set, e.g. how late the last pulse was
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fixed table of named counters and gauges.
+// Metrics are added once at startup; after that any thread can bump a counter or set a gauge with a relaxed
+// atomic and no lock, and readers (datarefs, the debug panel) load them whenever they like.
+class MetricsRegistry {
+public:
+    MetricsRegistry();
+
+    // name is the dataref leaf, label is what the debug panel shows. Returns the id, -1 when the table is full.
+    int addCounter(const char* name, const char* label);
+    int addGauge(const char* name, const char* label);
+
+    void increment(int id, int by = 1) {
+        if (id >= 0) counters[id].fetch_add(by, std::memory_order_relaxed);
+    }
+    void set(int id, float value) {
+        if (id >= 0) gauges[id].store(value, std::memory_order_relaxed);
+    }
+
+    int count(int id) const { return counters[id].load(std::memory_order_relaxed); }
+    float gauge(int id) const { return gauges[id].load(std::memory_order_relaxed); }
+
+    // Zero every value, the table itself is kept
+    void reset();
+
+    int size() const { return metricCount; }
+    const char* name(int id) const { return names[id]; }
+    const char* label(int id) const { return labels[id]; }
+    MetricKind kind(int id) const { return kinds[id]; }
+
+    // What to hand to PublishedDataRefs
+    const std::atomic<int>* counterValue(int id) const { return &counters[id]; }
+    const std::atomic<float>* gaugeValue(int id) const { return &gauges[id]; }
+
+private:
+    int add(const char* name, const char* label, MetricKind kind);
+
+    const char* names[METRICS_MAX];
+    const char* labels[METRICS_MAX];
+    MetricKind kinds[METRICS_MAX];
+    std::atomic<int> counters[METRICS_MAX];
+    std::atomic<float> gauges[METRICS_MAX];
+    int metricCount;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,39 @@
+#include "phase_timer.h"
+
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PhaseTimer::PhaseTimer(const char* name)
+    : timerName(name),
+      start(Clock::now()),
+      phaseStart(start),
+      phaseCount(0) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PhaseTimer::mark(const char* phase) {
+    Clock::time_point now = Clock::now();
+    if (phaseCount < PHASE_TIMER_MAX) {
+        phaseNames[phaseCount] = phase;
+        phaseMs[phaseCount] = std::chrono::duration<double, std::milli>(now - phaseStart).count();
+        phaseCount++;
+    }
+    phaseStart = now;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double PhaseTimer::totalMs() const {
+    return std::chrono::duration<double, std::milli>(phaseStart - start).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PhaseTimer::format(char* text, int size) const {
+    int used = snprintf(text, size, "%s %.2f ms:", timerName, totalMs());
+    for (int i = 0; i < phaseCount && used > 0 && used < size; i++) {
+        used += snprintf(text + used, size - used, "%s %s %.2f", i ? "," : "", phaseNames[i], phaseMs[i]);
+    }
+}
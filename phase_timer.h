@@ -0,0 +1,35 @@
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <chrono>
+
+#define PHASE_TIMER_MAX     16      // Most phases one timer records
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Times the phases of a one-off sequence such as plugin start or stop.
+// Call mark() at the end of each phase; format() gives one line with the total and every phase, for the log.
+class PhaseTimer {
+public:
+    explicit PhaseTimer(const char* name);
+
+    // End the current phase and start the next one
+    void mark(const char* phase);
+
+    double totalMs() const;
+
+    // "XPluginStop 1.23 ms: pulse thread 0.05, widgets 0.30, audio 0.88"
+    void format(char* text, int size) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    const char* timerName;
+    Clock::time_point start;
+    Clock::time_point phaseStart;
+    const char* phaseNames[PHASE_TIMER_MAX];
+    double phaseMs[PHASE_TIMER_MAX];
+    int phaseCount;
+};
+
+#endif // PHASE_TIMER_H
@@ -0,0 +1,182 @@
+#include "profile_store.h"
+#include "logger.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Create the folder a file goes in, one level only: the parent of that folder has to exist
+static bool makeParentDirectory(const char* path) {
+    char directory[PROFILE_PATH_MAX];
+    snprintf(directory, sizeof(directory), "%s", path);
+    char* slash = strrchr(directory, '/');
+    char* backslash = strrchr(directory, '\\');
+    if (backslash > slash) {
+        slash = backslash;
+    }
+    if (!slash) {
+        return true;
+    }
+    *slash = '\0';
+#ifdef _WIN32
+    return _mkdir(directory) == 0 || errno == EEXIST;
+#else
+    return mkdir(directory, 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+ProfileStore::ProfileStore()
+    : running(false),
+      loadPending(false),
+      loadGeneration(0),
+      savePending(false),
+      loadReady(false) {
+    loadPath[0] = '\0';
+    loadAircraft[0] = '\0';
+    savePath[0] = '\0';
+    saveProfile = defaultAircraftProfile();
+    loaded.status = ProfileLoadStatus::Missing;
+    loaded.profile = defaultAircraftProfile();
+    loaded.path[0] = '\0';
+    loaded.error[0] = '\0';
+}
+
+ProfileStore::~ProfileStore() {
+    stop();
+}
+
+void ProfileStore::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&ProfileStore::threadFunction, this);
+}
+
+// Finishes a queued save before returning, so a profile written just before unload isn't lost
+void ProfileStore::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ProfileStore::requestLoad(const char* path, const char* aircraft) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        snprintf(loadPath, sizeof(loadPath), "%s", path);
+        snprintf(loadAircraft, sizeof(loadAircraft), "%s", aircraft);
+        loadGeneration++;
+        loadPending = true;
+        loadReady.store(false, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+void ProfileStore::requestSave(const char* path, const AircraftProfile& profile) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        snprintf(savePath, sizeof(savePath), "%s", path);
+        saveProfile = profile;
+        savePending = true;
+    }
+    wake.notify_one();
+}
+
+bool ProfileStore::takeLoaded(ProfileLoad& load) {
+    if (!loadReady.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!loadReady.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    load = loaded;
+    loadReady.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// File work happens with the lock released; the request is copied out first
+void ProfileStore::threadFunction() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return !running || loadPending || savePending; });
+
+        if (savePending) {
+            char path[PROFILE_PATH_MAX];
+            snprintf(path, sizeof(path), "%s", savePath);
+            AircraftProfile profile = saveProfile;
+            savePending = false;
+            lock.unlock();
+
+            if (makeParentDirectory(path) && saveAircraftProfile(path, profile)) {
+                LOG_INFO("Saved aircraft profile %s", path);
+            } else {
+                LOG_ERROR("Failed to save aircraft profile %s", path);
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (loadPending) {
+            ProfileLoad load;
+            char aircraft[AIRCRAFT_NAME_MAX];
+            snprintf(load.path, sizeof(load.path), "%s", loadPath);
+            snprintf(aircraft, sizeof(aircraft), "%s", loadAircraft);
+            unsigned generation = loadGeneration;
+            loadPending = false;
+            lock.unlock();
+
+            load.profile = defaultAircraftProfile();
+            load.error[0] = '\0';
+            FILE* file = fopen(load.path, "rb");
+            if (!file) {
+                load.status = ProfileLoadStatus::Missing;
+            } else {
+                fclose(file);
+                AircraftProfile profile;
+                if (!loadAircraftProfile(load.path, profile, load.error, sizeof(load.error))) {
+                    load.status = ProfileLoadStatus::Invalid;
+                } else if (profile.aircraft[0] && strcmp(profile.aircraft, aircraft)) {
+                    load.status = ProfileLoadStatus::Invalid;
+                    snprintf(load.error, sizeof(load.error), "profile is for %s", profile.aircraft);
+                } else {
+                    load.status = ProfileLoadStatus::Loaded;
+                    load.profile = profile;
+                }
+            }
+            snprintf(load.profile.aircraft, sizeof(load.profile.aircraft), "%s", aircraft);
+
+            lock.lock();
+            if (generation == loadGeneration) {
+                loaded = load;
+                loadReady.store(true, std::memory_order_release);
+            }
+            continue;
+        }
+
+        if (!running) {
+            return;
+        }
+    }
+}
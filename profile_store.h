@@ -0,0 +1,71 @@
+#ifndef PROFILE_STORE_H
+#define PROFILE_STORE_H
+
+#include "aircraft_profile.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define PROFILE_PATH_MAX        512
+
+enum class ProfileLoadStatus {
+    Loaded,         // profile parsed and valid
+    Missing,        // no profile for this aircraft yet, defaults apply
+    Invalid         // file exists but didn't parse, see error
+};
+
+struct ProfileLoad {
+    ProfileLoadStatus status;
+    AircraftProfile profile;        // defaults unless Loaded
+    char path[PROFILE_PATH_MAX];
+    char error[160];
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reads and writes aircraft profiles on a background thread so the sim thread never touches the disk.
+// The sim thread queues requests and polls for finished loads once a frame; polling is one atomic load
+// unless a load has finished. Only the newest load request counts: one queued or in flight when another
+// comes in (aircraft switched twice quickly) is dropped.
+class ProfileStore {
+public:
+    ProfileStore();
+    ~ProfileStore();
+
+    void start();
+    void stop();
+
+    // Load path for the aircraft with this acf file name. A profile naming another aircraft is rejected.
+    void requestLoad(const char* path, const char* aircraft);
+
+    // Write a profile, creating its folder if needed. Failures are reported through the logger.
+    void requestSave(const char* path, const AircraftProfile& profile);
+
+    // Returns true, once, when the latest requested load has finished
+    bool takeLoaded(ProfileLoad& load);
+
+private:
+    void threadFunction();
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+
+    // Requests, guarded by mutex
+    bool loadPending;
+    char loadPath[PROFILE_PATH_MAX];
+    char loadAircraft[AIRCRAFT_NAME_MAX];
+    unsigned loadGeneration;            // bumped by every requestLoad
+    bool savePending;
+    char savePath[PROFILE_PATH_MAX];
+    AircraftProfile saveProfile;
+
+    // Finished load, guarded by mutex, flagged by loadReady
+    ProfileLoad loaded;
+    std::atomic<bool> loadReady;
+};
+
+#endif // PROFILE_STORE_H
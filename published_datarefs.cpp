@@ -0,0 +1,79 @@
+#include "published_datarefs.h"
+#include "logger.h"
+
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PublishedDataRefs::PublishedDataRefs()
+    : refCount(0) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool PublishedDataRefs::addFloat(const char* name, const std::atomic<float>* value) {
+    if (refCount >= PUBLISHED_DATAREFS_MAX) {
+        return false;
+    }
+
+    XPLMDataRef ref = XPLMRegisterDataAccessor(name, xplmType_Float, 0,
+        nullptr, nullptr,
+        readFloat, nullptr,
+        nullptr, nullptr,
+        nullptr, nullptr,
+        nullptr, nullptr,
+        nullptr, nullptr,
+        const_cast<std::atomic<float>*>(value), nullptr);
+    if (ref == nullptr) {
+        LOG_ERROR("Failed to register DataRef %s", name);
+        return false;
+    }
+
+    refs[refCount++] = ref;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool PublishedDataRefs::addInt(const char* name, const std::atomic<int>* value) {
+    if (refCount >= PUBLISHED_DATAREFS_MAX) {
+        return false;
+    }
+
+    XPLMDataRef ref = XPLMRegisterDataAccessor(name, xplmType_Int, 0,
+        readInt, nullptr,
+        nullptr, nullptr,
+        nullptr, nullptr,
+        nullptr, nullptr,
+        nullptr, nullptr,
+        nullptr, nullptr,
+        const_cast<std::atomic<int>*>(value), nullptr);
+    if (ref == nullptr) {
+        LOG_ERROR("Failed to register DataRef %s", name);
+        return false;
+    }
+
+    refs[refCount++] = ref;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PublishedDataRefs::unregisterAll() {
+    for (int i = 0; i < refCount; i++) {
+        XPLMUnregisterDataAccessor(refs[i]);
+    }
+    refCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+float PublishedDataRefs::readFloat(void* refcon) {
+    return static_cast<const std::atomic<float>*>(refcon)->load(std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int PublishedDataRefs::readInt(void* refcon) {
+    return static_cast<const std::atomic<int>*>(refcon)->load(std::memory_order_relaxed);
+}
@@ -0,0 +1,34 @@
+#ifndef PUBLISHED_DATAREFS_H
+#define PUBLISHED_DATAREFS_H
+
+#include "SDK/CHeaders/XPLM/XPLMDataAccess.h"
+
+#include <atomic>
+
+#define PUBLISHED_DATAREFS_MAX     32      // Most datarefs one set can publish
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Read-only datarefs backed by atomics that we own.
+// Whoever computes a value just stores it into its atomic; the accessors load it with no locking, so any
+// plugin or instrument can read the value at any time without us doing the work twice.
+// The atomics must outlive the registration.
+class PublishedDataRefs {
+public:
+    PublishedDataRefs();
+    ~PublishedDataRefs() { unregisterAll(); }
+
+    bool addFloat(const char* name, const std::atomic<float>* value);
+    bool addInt(const char* name, const std::atomic<int>* value);
+
+    void unregisterAll();
+
+private:
+    static float readFloat(void* refcon);
+    static int readInt(void* refcon);
+
+    XPLMDataRef refs[PUBLISHED_DATAREFS_MAX];
+    int refCount;
+};
+
+#endif // PUBLISHED_DATAREFS_H
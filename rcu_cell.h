@@ -0,0 +1,113 @@
+#ifndef RCU_CELL_H
+#define RCU_CELL_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A value one writer replaces whole and other threads read without locks, read-copy-update style.
+//
+// Every published value is an immutable heap copy; publish() swaps the pointer, so a reader sees either the
+// old value or the new one, never a mix. read() is a single atomic load and never waits. Old copies are freed
+// once every registered reader has passed a quiescent point, a place where it holds no pointer from read(),
+// since the copy was replaced. Readers mark those points with quiescent(), e.g. once per loop iteration.
+//
+//   sim thread:    cell.publish(newValue);             // writer, may allocate
+//   other thread:  const T* value = cell.read();       // use *value ...
+//                  cell.quiescent(reader);             // ... and drop it before this
+//
+// The writer can read its own value with read() without registering. publish() and reclaim() must only be
+// called from the one writer thread.
+template <typename T, int MaxReaders = 4>
+class RcuCell {
+public:
+    explicit RcuCell(const T& initial) : current(new T(initial)), epoch(0) {
+        for (auto& seen : readerEpochs) {
+            seen.store(READER_INACTIVE);
+        }
+    }
+
+    ~RcuCell() {
+        delete current.load();
+        for (const Retired& retired : retiredList) {
+            delete retired.value;
+        }
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    // Reader threads. Returns a slot to pass to quiescent(), or -1 if MaxReaders are registered already.
+    int registerReader() {
+        for (int i = 0; i < MaxReaders; i++) {
+            uint64_t inactive = READER_INACTIVE;
+            if (readerEpochs[i].compare_exchange_strong(inactive, epoch.load())) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void unregisterReader(int reader) {
+        readerEpochs[reader].store(READER_INACTIVE);
+    }
+
+    const T* read() const {
+        return current.load();
+    }
+
+    // The calling reader holds no pointer it got from read() before this call
+    void quiescent(int reader) {
+        readerEpochs[reader].store(epoch.load());
+    }
+
+    // Writer thread. Swap in a copy of value, retire the old one and free whatever readers have moved past.
+    void publish(const T& value) {
+        T* previous = current.exchange(new T(value));
+        uint64_t retiredAt = epoch.fetch_add(1) + 1;
+        retiredList.push_back(Retired{previous, retiredAt});
+        reclaim();
+    }
+
+    // Writer thread. Free retired copies no reader can still hold.
+    void reclaim() {
+        uint64_t oldestSeen = READER_INACTIVE;
+        for (const auto& seen : readerEpochs) {
+            uint64_t readerEpoch = seen.load();
+            if (readerEpoch < oldestSeen) {
+                oldestSeen = readerEpoch;
+            }
+        }
+
+        size_t kept = 0;
+        for (const Retired& retired : retiredList) {
+            if (retired.epoch <= oldestSeen) {
+                delete retired.value;
+            } else {
+                retiredList[kept++] = retired;
+            }
+        }
+        retiredList.resize(kept);
+    }
+
+    size_t retiredCount() const { return retiredList.size(); }
+
+private:
+    static const uint64_t READER_INACTIVE = UINT64_MAX;
+
+    struct Retired {
+        T* value;
+        uint64_t epoch;         // readers that have seen this epoch can no longer hold value
+    };
+
+    // All sequentially consistent: a reader that has seen the epoch bumped after a swap must also see the
+    // new pointer on its next read()
+    std::atomic<T*> current;
+    std::atomic<uint64_t> epoch;
+    std::atomic<uint64_t> readerEpochs[MaxReaders];
+    std::vector<Retired> retiredList;       // writer only
+};
+
+#endif // RCU_CELL_H
@@ -0,0 +1,53 @@
+#include "scope_buffer.h"
+
+static_assert((SCOPE_CAPACITY & (SCOPE_CAPACITY - 1)) == 0, "SCOPE_CAPACITY must be a power of two");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+ScopeBuffer::ScopeBuffer()
+    : samples(),
+      sampleCount(0) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Walks back from the newest sample until it is more than seconds old
+double ScopeBuffer::decimate(double seconds, int columns, ScopeColumn* out) const {
+    if (columns > SCOPE_COLUMNS_MAX) {
+        columns = SCOPE_COLUMNS_MAX;
+    }
+    if (columns < 1 || seconds <= 0.0 || sampleCount == 0) {
+        return -1.0;
+    }
+
+    for (int c = 0; c < columns; c++) {
+        out[c] = ScopeColumn{0.0f, 0.0f, 0.0f, 0.0f, 0, 0};
+    }
+
+    uint64_t end = sampleCount;
+    uint64_t available = end < SCOPE_CAPACITY ? end : SCOPE_CAPACITY;
+    double newest = samples[(end - 1) & (SCOPE_CAPACITY - 1)].time;
+    double start = newest - seconds;
+    for (uint64_t i = end; i > end - available; i--) {
+        const ScopeSample& sample = samples[(i - 1) & (SCOPE_CAPACITY - 1)];
+        if (sample.time < start) {
+            break;
+        }
+
+        int c = static_cast<int>((sample.time - start) / seconds * columns);
+        c = c < 0 ? 0 : c >= columns ? columns - 1 : c;
+        ScopeColumn& column = out[c];
+        if (column.count == 0) {
+            column.rawMin = column.rawMax = sample.rawAoa;
+            column.avgMin = column.avgMax = sample.avgAoa;
+        } else {
+            column.rawMin = sample.rawAoa < column.rawMin ? sample.rawAoa : column.rawMin;
+            column.rawMax = sample.rawAoa > column.rawMax ? sample.rawAoa : column.rawMax;
+            column.avgMin = sample.avgAoa < column.avgMin ? sample.avgAoa : column.avgMin;
+            column.avgMax = sample.avgAoa > column.avgMax ? sample.avgAoa : column.avgMax;
+        }
+        column.count++;
+        column.flags |= sample.flags;
+    }
+    return newest;
+}
@@ -0,0 +1,56 @@
+#ifndef SCOPE_BUFFER_H
+#define SCOPE_BUFFER_H
+
+#include <cstdint>
+
+#define SCOPE_CAPACITY          4096    // Samples, a power of two. About 68 s at 60 fps.
+#define SCOPE_COLUMNS_MAX       1024
+
+// ScopeSample::flags and ScopeColumn::flags
+#define SCOPE_PULSE_ONSET       0x01    // the pulse thread started a pulse since the previous sample
+#define SCOPE_SPIKE             0x02    // the raw sample was rejected by the spike filter
+
+// One flight loop frame
+struct ScopeSample {
+    double time;            // seconds of sim time, increasing
+    float rawAoa;           // degrees, before the spike filter
+    float avgAoa;           // degrees, after the spike filter and moving average
+    uint8_t zone;           // ToneZone
+    uint8_t flags;          // SCOPE_*
+};
+
+// Every sample that falls in one pixel column. Empty columns have count 0.
+struct ScopeColumn {
+    float rawMin, rawMax;
+    float avgMin, avgMax;
+    int count;
+    uint8_t flags;          // SCOPE_* of any sample in the column
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fixed ring of the most recent frames for the scope window. Sim thread only: the flight loop pushes and the
+// window's draw callback decimates, both on the sim thread, so a push can never land in the middle of a
+// decimate and there is nothing to synchronize. No allocation after construction.
+class ScopeBuffer {
+public:
+    ScopeBuffer();
+
+    void push(const ScopeSample& sample) {
+        samples[sampleCount & (SCOPE_CAPACITY - 1)] = sample;
+        sampleCount++;
+    }
+
+    uint64_t count() const { return sampleCount; }
+
+    // Reduce the last seconds of samples to columns pixel columns, oldest on the left, keeping each column's
+    // min and max so spikes and short pulses survive however many samples share a pixel. columns is clamped to
+    // SCOPE_COLUMNS_MAX. Returns the time of the newest sample, or a negative number if there are none.
+    double decimate(double seconds, int columns, ScopeColumn* out) const;
+
+private:
+    ScopeSample samples[SCOPE_CAPACITY];
+    uint64_t sampleCount;
+};
+
+#endif // SCOPE_BUFFER_H
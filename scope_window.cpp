@@ -0,0 +1,228 @@
+#include "scope_window.h"
+#include "aoa_tape.h"
+#include "SDK/CHeaders/XPLM/XPLMGraphics.h"
+
+#if IBM
+    #include <windows.h>
+    #include <GL/gl.h>
+#elif APL
+    #include <OpenGL/gl.h>
+#else
+    #include <GL/gl.h>
+#endif
+
+#include <cmath>
+#include <cstdio>
+
+static float TEXT_COLOR[3] = {1.0f, 1.0f, 1.0f};
+static float DIM_TEXT_COLOR[3] = {0.7f, 0.7f, 0.7f};
+
+static const float RAW_COLOR[4] = {0.55f, 0.55f, 0.60f, 1.0f};
+static const float AVG_COLOR[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+static const float PULSE_COLOR[4] = {0.30f, 0.85f, 1.0f, 1.0f};
+static const float SPIKE_COLOR[4] = {1.0f, 0.2f, 0.2f, 1.0f};
+
+// Pixels around the plot: labels on the left, pulse marks and the legend underneath
+static const float PLOT_MARGIN_LEFT = 36.0f;
+static const float PLOT_MARGIN_RIGHT = 10.0f;
+static const float PLOT_MARGIN_TOP = 10.0f;
+static const float PLOT_MARGIN_BOTTOM = 34.0f;
+static const float MARK_HEIGHT = 8.0f;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+ScopeWindow::ScopeWindow(const ScopeBuffer& scopeBuffer)
+    : buffer(scopeBuffer),
+      window(nullptr),
+      thresholds(defaultAoaThresholds()),
+      seconds(SCOPE_SECONDS_DEFAULT),
+      columns() {
+}
+
+void ScopeWindow::create(int left, int top, int right, int bottom) {
+    if (window) {
+        return;
+    }
+
+    XPLMCreateWindow_t params;
+    params.structSize = sizeof(params);
+    params.left = left;
+    params.top = top;
+    params.right = right;
+    params.bottom = bottom;
+    params.visible = 1;
+    params.drawWindowFunc = drawCallback;
+    params.handleMouseClickFunc = clickCallback;
+    params.handleRightClickFunc = clickCallback;
+    params.handleKeyFunc = keyCallback;
+    params.handleCursorFunc = cursorCallback;
+    params.handleMouseWheelFunc = wheelCallback;
+    params.refcon = this;
+    params.decorateAsFloatingWindow = xplm_WindowDecorationRoundRectangle;
+    params.layer = xplm_WindowLayerFloatingWindows;
+    window = XPLMCreateWindowEx(&params);
+    XPLMSetWindowTitle(window, "Fly On Speed Scope");
+}
+
+void ScopeWindow::destroy() {
+    if (window) {
+        XPLMDestroyWindow(window);
+        window = nullptr;
+    }
+}
+
+bool ScopeWindow::isVisible() const {
+    return window && XPLMGetWindowIsVisible(window);
+}
+
+void ScopeWindow::setVisible(bool visible) {
+    if (window) {
+        XPLMSetWindowIsVisible(window, visible ? 1 : 0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ScopeWindow::drawCallback(XPLMWindowID, void* refcon) {
+    static_cast<ScopeWindow*>(refcon)->draw();
+}
+
+int ScopeWindow::clickCallback(XPLMWindowID, int, int, XPLMMouseStatus, void*) {
+    return 1;
+}
+
+void ScopeWindow::keyCallback(XPLMWindowID, char, XPLMKeyFlags, char, void*, int) {
+}
+
+XPLMCursorStatus ScopeWindow::cursorCallback(XPLMWindowID, int, int, void*) {
+    return xplm_CursorDefault;
+}
+
+// Each click of the wheel halves or doubles the time span, wheel up zooms in
+int ScopeWindow::wheelCallback(XPLMWindowID, int, int, int, int clicks, void* refcon) {
+    ScopeWindow* scope = static_cast<ScopeWindow*>(refcon);
+    scope->seconds *= std::pow(2.0, -clicks);
+    scope->seconds = scope->seconds < SCOPE_SECONDS_MIN ? SCOPE_SECONDS_MIN
+                   : scope->seconds > SCOPE_SECONDS_MAX ? SCOPE_SECONDS_MAX : scope->seconds;
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Each trace is one vertical line per pixel column from its min to its max, stretched to meet the column before
+// so a steep climb still reads as a connected line. Columns with no samples are bridged by a line between the
+// middles of their non-empty neighbours.
+static void drawTrace(const ScopeColumn* columns, int count, bool raw, float plotLeft, float plotBottom,
+                      float plotTop, float aoaMin, float aoaMax) {
+    float scale = (plotTop - plotBottom) / (aoaMax - aoaMin);
+    auto toY = [=](float aoa) {
+        float y = plotBottom + (aoa - aoaMin) * scale;
+        return y < plotBottom ? plotBottom : y > plotTop ? plotTop : y;
+    };
+    const ScopeColumn* previous = nullptr;
+    float previousX = 0.0f;
+
+    glBegin(GL_LINES);
+    for (int c = 0; c < count; c++) {
+        const ScopeColumn& column = columns[c];
+        if (column.count == 0) {
+            continue;
+        }
+        float low = raw ? column.rawMin : column.avgMin;
+        float high = raw ? column.rawMax : column.avgMax;
+        float x = plotLeft + c + 0.5f;
+        if (previous) {
+            float previousLow = raw ? previous->rawMin : previous->avgMin;
+            float previousHigh = raw ? previous->rawMax : previous->avgMax;
+            if (x - previousX > 1.0f) {
+                // Fewer samples than columns at short spans
+                glVertex2f(previousX, toY(0.5f * (previousLow + previousHigh)));
+                glVertex2f(x, toY(0.5f * (low + high)));
+            } else {
+                low = previousHigh < low ? previousHigh : low;
+                high = previousLow > high ? previousLow : high;
+            }
+        }
+        glVertex2f(x, toY(low));
+        glVertex2f(x, toY(high + 1.0f / scale));     // at least a pixel tall
+        previous = &column;
+        previousX = x;
+    }
+    glEnd();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ScopeWindow::draw() {
+    int left, top, right, bottom;
+    XPLMGetWindowGeometry(window, &left, &top, &right, &bottom);
+
+    float plotLeft = left + PLOT_MARGIN_LEFT;
+    float plotRight = right - PLOT_MARGIN_RIGHT;
+    float plotBottom = bottom + PLOT_MARGIN_BOTTOM;
+    float plotTop = top - PLOT_MARGIN_TOP;
+    int width = static_cast<int>(plotRight - plotLeft);
+    if (width < 1 || plotTop <= plotBottom) {
+        return;
+    }
+    width = width > SCOPE_COLUMNS_MAX ? SCOPE_COLUMNS_MAX : width;
+
+    // Same AOA span as the tape
+    float aoaMin = std::floor(thresholds.belowLDMax - AOA_TAPE_MARGIN_BELOW);
+    float aoaMax = std::ceil(thresholds.aboveOnSpeedMax + AOA_TAPE_MARGIN_ABOVE);
+    float scale = (plotTop - plotBottom) / (aoaMax - aoaMin);
+
+    double newest = buffer.decimate(seconds, width, columns);
+
+    XPLMSetGraphicsState(0, 0, 0, 0, 1, 0, 0);
+
+    // Setpoints, each in the colour of the zone above it
+    const float setpoints[4] = {thresholds.belowLDMax, thresholds.belowOnSpeed, thresholds.onSpeedMax,
+                                thresholds.aboveOnSpeedMax};
+    const ToneZone above[4] = {ToneZone::BelowOnSpeed, ToneZone::OnSpeed, ToneZone::AboveOnSpeed, ToneZone::Stall};
+    glBegin(GL_LINES);
+    for (int i = 0; i < 4; i++) {
+        float y = plotBottom + (setpoints[i] - aoaMin) * scale;
+        glColor4fv(toneZoneColor(above[i]));
+        glVertex2f(plotLeft, y);
+        glVertex2f(plotLeft + width, y);
+    }
+    glEnd();
+
+    if (newest >= 0.0) {
+        glColor4fv(RAW_COLOR);
+        drawTrace(columns, width, true, plotLeft, plotBottom, plotTop, aoaMin, aoaMax);
+        glColor4fv(AVG_COLOR);
+        drawTrace(columns, width, false, plotLeft, plotBottom, plotTop, aoaMin, aoaMax);
+
+        // Pulse onsets along the bottom, rejected spikes along the top
+        glBegin(GL_LINES);
+        for (int c = 0; c < width; c++) {
+            float x = plotLeft + c + 0.5f;
+            if (columns[c].flags & SCOPE_PULSE_ONSET) {
+                glColor4fv(PULSE_COLOR);
+                glVertex2f(x, plotBottom - 4.0f - MARK_HEIGHT);
+                glVertex2f(x, plotBottom - 4.0f);
+            }
+            if (columns[c].flags & SCOPE_SPIKE) {
+                glColor4fv(SPIKE_COLOR);
+                glVertex2f(x, plotTop - MARK_HEIGHT);
+                glVertex2f(x, plotTop);
+            }
+        }
+        glEnd();
+    }
+
+    char text[64];
+    for (int i = 0; i < 4; i++) {
+        snprintf(text, sizeof(text), "%.1f", setpoints[i]);
+        XPLMDrawString(DIM_TEXT_COLOR, left + 4, static_cast<int>(plotBottom + (setpoints[i] - aoaMin) * scale) - 4,
+                       text, nullptr, xplmFont_Proportional);
+    }
+    if (newest < 0.0) {
+        snprintf(text, sizeof(text), "No data yet");
+    } else {
+        snprintf(text, sizeof(text), "Raw (grey), filtered (white), pulses, spikes. Last %.0f s", seconds);
+    }
+    XPLMDrawString(TEXT_COLOR, static_cast<int>(plotLeft), bottom + 6, text, nullptr, xplmFont_Proportional);
+}
@@ -0,0 +1,51 @@
+#ifndef SCOPE_WINDOW_H
+#define SCOPE_WINDOW_H
+
+#include "aoa_engine.h"
+#include "scope_buffer.h"
+#include "SDK/CHeaders/XPLM/XPLMDisplay.h"
+
+#define SCOPE_SECONDS_DEFAULT   10.0    // Seconds across the scope
+#define SCOPE_SECONDS_MIN       2.0
+#define SCOPE_SECONDS_MAX       60.0    // Less than SCOPE_CAPACITY frames at 60 fps
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A floating XPLM window plotting the last few seconds of raw and filtered AOA against the setpoints, with a
+// mark for every pulse onset and every sample the spike filter threw away. For tuning the filter length and
+// spike limit in the sim: the gap between the two traces is the filter lag.
+// The flight loop pushes a sample per frame into a ScopeBuffer whether or not the window is open; the draw
+// callback, only called while the window is visible, reduces it to one min/max column per pixel. The mouse
+// wheel zooms between SCOPE_SECONDS_MIN and SCOPE_SECONDS_MAX. Sim thread only, like the buffer.
+class ScopeWindow {
+public:
+    explicit ScopeWindow(const ScopeBuffer& buffer);
+
+    void create(int left, int top, int right, int bottom);
+    void destroy();
+    bool exists() const { return window != nullptr; }
+
+    bool isVisible() const;
+    void setVisible(bool visible);
+
+    // Call every frame from the flight loop
+    void setThresholds(const AoaThresholds& current) { thresholds = current; }
+
+private:
+    static void drawCallback(XPLMWindowID window, void* refcon);
+    static int clickCallback(XPLMWindowID window, int x, int y, XPLMMouseStatus status, void* refcon);
+    static void keyCallback(XPLMWindowID window, char key, XPLMKeyFlags flags, char virtualKey, void* refcon,
+                            int losingFocus);
+    static XPLMCursorStatus cursorCallback(XPLMWindowID window, int x, int y, void* refcon);
+    static int wheelCallback(XPLMWindowID window, int x, int y, int wheel, int clicks, void* refcon);
+
+    void draw();
+
+    const ScopeBuffer& buffer;
+    XPLMWindowID window;
+    AoaThresholds thresholds;
+    double seconds;
+    ScopeColumn columns[SCOPE_COLUMNS_MAX];
+};
+
+#endif // SCOPE_WINDOW_H
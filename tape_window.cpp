@@ -0,0 +1,166 @@
+#include "tape_window.h"
+#include "SDK/CHeaders/XPLM/XPLMGraphics.h"
+
+#if IBM
+    #include <windows.h>
+    #include <GL/gl.h>
+#elif APL
+    #include <OpenGL/gl.h>
+#else
+    #include <GL/gl.h>
+#endif
+
+#include <cstdio>
+
+static float TEXT_COLOR[3] = {1.0f, 1.0f, 1.0f};
+static float DIM_TEXT_COLOR[3] = {0.7f, 0.7f, 0.7f};
+
+static const float POINTER_SIZE = 8.0f;     // pixels
+static const int LINE_HEIGHT = 16;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TapeWindow::TapeWindow()
+    : window(nullptr),
+      lastFrame(),
+      lastThresholds(),
+      hasFrame(false),
+      layout(),
+      hasLayout(false) {
+}
+
+void TapeWindow::create(int left, int top, int right, int bottom) {
+    if (window) {
+        return;
+    }
+
+    XPLMCreateWindow_t params;
+    params.structSize = sizeof(params);
+    params.left = left;
+    params.top = top;
+    params.right = right;
+    params.bottom = bottom;
+    params.visible = 1;
+    params.drawWindowFunc = drawCallback;
+    params.handleMouseClickFunc = clickCallback;
+    params.handleRightClickFunc = clickCallback;
+    params.handleKeyFunc = keyCallback;
+    params.handleCursorFunc = cursorCallback;
+    params.handleMouseWheelFunc = wheelCallback;
+    params.refcon = this;
+    params.decorateAsFloatingWindow = xplm_WindowDecorationRoundRectangle;
+    params.layer = xplm_WindowLayerFloatingWindows;
+    window = XPLMCreateWindowEx(&params);
+    XPLMSetWindowTitle(window, "Fly On Speed AOA");
+    hasLayout = false;
+}
+
+void TapeWindow::destroy() {
+    if (window) {
+        XPLMDestroyWindow(window);
+        window = nullptr;
+    }
+}
+
+bool TapeWindow::isVisible() const {
+    return window && XPLMGetWindowIsVisible(window);
+}
+
+void TapeWindow::setVisible(bool visible) {
+    if (window) {
+        XPLMSetWindowIsVisible(window, visible ? 1 : 0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TapeWindow::drawCallback(XPLMWindowID, void* refcon) {
+    static_cast<TapeWindow*>(refcon)->draw();
+}
+
+// Swallow clicks so they don't fall through to the cockpit; the decoration handles dragging
+int TapeWindow::clickCallback(XPLMWindowID, int, int, XPLMMouseStatus, void*) {
+    return 1;
+}
+
+void TapeWindow::keyCallback(XPLMWindowID, char, XPLMKeyFlags, char, void*, int) {
+}
+
+XPLMCursorStatus TapeWindow::cursorCallback(XPLMWindowID, int, int, void*) {
+    return xplm_CursorDefault;
+}
+
+int TapeWindow::wheelCallback(XPLMWindowID, int, int, int, int, void*) {
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Bands and ticks come straight from the cached layout; only the pointer and the readout lines depend on the
+// frame
+void TapeWindow::draw() {
+    if (!hasFrame) {
+        return;
+    }
+
+    int left, top, right, bottom;
+    XPLMGetWindowGeometry(window, &left, &top, &right, &bottom);
+    if (!hasLayout || !isAoaTapeLayoutFor(layout, left, top, right, bottom, lastThresholds)) {
+        layoutAoaTape(layout, left, top, right, bottom, lastThresholds);
+        hasLayout = true;
+    }
+
+    XPLMSetGraphicsState(0, 0, 0, 0, 1, 0, 0);
+
+    glBegin(GL_QUADS);
+    for (const AoaTapeBand& band : layout.bands) {
+        glColor4fv(toneZoneColor(band.zone));
+        glVertex2f(layout.tapeLeft, band.bottom);
+        glVertex2f(layout.tapeRight, band.bottom);
+        glVertex2f(layout.tapeRight, band.top);
+        glVertex2f(layout.tapeLeft, band.top);
+    }
+    glEnd();
+
+    glColor4f(1.0f, 1.0f, 1.0f, 0.6f);
+    glBegin(GL_LINES);
+    for (int i = 0; i < layout.tickCount; i++) {
+        glVertex2f(layout.tapeRight - 6.0f, layout.ticks[i].y);
+        glVertex2f(layout.tapeRight, layout.ticks[i].y);
+    }
+    glEnd();
+
+    // Pointer at the filtered AOA: a line across the tape and an arrow head on its right edge
+    float y = layout.aoaToY(lastFrame.avgAoa);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    glBegin(GL_LINES);
+    glVertex2f(layout.tapeLeft, y);
+    glVertex2f(layout.tapeRight, y);
+    glEnd();
+    glBegin(GL_TRIANGLES);
+    glVertex2f(layout.tapeRight, y);
+    glVertex2f(layout.tapeRight + POINTER_SIZE, y + POINTER_SIZE / 2);
+    glVertex2f(layout.tapeRight + POINTER_SIZE, y - POINTER_SIZE / 2);
+    glEnd();
+
+    int labelX = static_cast<int>(layout.tapeRight + POINTER_SIZE + 4.0f);
+    for (int i = 0; i < layout.tickCount; i++) {
+        XPLMDrawString(DIM_TEXT_COLOR, labelX, static_cast<int>(layout.ticks[i].y) - 4, layout.ticks[i].label,
+                       nullptr, xplmFont_Proportional);
+    }
+
+    char text[48];
+    int textX = labelX + 28;
+    int textY = top - 10 - LINE_HEIGHT;
+    snprintf(text, sizeof(text), "AOA %.1f", lastFrame.avgAoa);
+    XPLMDrawString(TEXT_COLOR, textX, textY, text, nullptr, xplmFont_Proportional);
+    textY -= LINE_HEIGHT;
+    XPLMDrawString(TEXT_COLOR, textX, textY, toneZoneName(lastFrame.tone.zone), nullptr,
+                   xplmFont_Proportional);
+    textY -= LINE_HEIGHT;
+    formatTapeToneText(text, sizeof(text), lastFrame);
+    XPLMDrawString(TEXT_COLOR, textX, textY, text, nullptr, xplmFont_Proportional);
+    textY -= LINE_HEIGHT;
+    snprintf(text, sizeof(text), "IAS %.0f", lastFrame.ias);
+    XPLMDrawString(DIM_TEXT_COLOR, textX, textY, text, nullptr, xplmFont_Proportional);
+}
@@ -0,0 +1,52 @@
+#ifndef TAPE_WINDOW_H
+#define TAPE_WINDOW_H
+
+#include "aoa_tape.h"
+#include "ui_text.h"
+#include "SDK/CHeaders/XPLM/XPLMDisplay.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A floating XPLM window drawing a live AOA tape: the zone bands, a pointer at the filtered AOA, and the zone,
+// pulse rate and tone frequency beside it.
+// The flight loop hands over each frame with update(), a struct copy. Nothing else happens until X-Plane calls
+// the draw callback, which it only does while the window is visible. The band and tick geometry is laid out
+// once and only redone when the window is moved or resized or the setpoints change. Sim thread only.
+class TapeWindow {
+public:
+    TapeWindow();
+
+    void create(int left, int top, int right, int bottom);
+    void destroy();
+    bool exists() const { return window != nullptr; }
+
+    bool isVisible() const;
+    void setVisible(bool visible);
+
+    // Call every frame from the flight loop
+    void update(const LiveFrame& frame, const AoaThresholds& thresholds) {
+        lastFrame = frame;
+        lastThresholds = thresholds;
+        hasFrame = true;
+    }
+
+private:
+    static void drawCallback(XPLMWindowID window, void* refcon);
+    static int clickCallback(XPLMWindowID window, int x, int y, XPLMMouseStatus status, void* refcon);
+    static void keyCallback(XPLMWindowID window, char key, XPLMKeyFlags flags, char virtualKey, void* refcon,
+                            int losingFocus);
+    static XPLMCursorStatus cursorCallback(XPLMWindowID window, int x, int y, void* refcon);
+    static int wheelCallback(XPLMWindowID window, int x, int y, int wheel, int clicks, void* refcon);
+
+    void draw();
+
+    XPLMWindowID window;
+    LiveFrame lastFrame;
+    AoaThresholds lastThresholds;
+    bool hasFrame;
+
+    AoaTapeLayout layout;
+    bool hasLayout;
+};
+
+#endif // TAPE_WINDOW_H
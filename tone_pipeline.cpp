@@ -0,0 +1,81 @@
+#include "tone_pipeline.h"
+
+static TonePipelineListener nullListener;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TonePipeline::TonePipeline(const AoaThresholds& thresholds, const ToneSettings& tone, TonePipelineListener* listener,
+                           int filterWindow, float spikeLimit)
+    : zoneThresholds(thresholds),
+      toneSettings(tone),
+      listener(listener ? listener : &nullListener),
+      aoaFilter(filterWindow, spikeLimit) {
+    reset();
+}
+
+void TonePipeline::reset() {
+    aoaFilter.reset();
+    lastZone = ToneZone::BelowIAS;
+    audioEnabled = false;
+    shouldPlay = false;
+    currentAoa = 0.0f;
+    pulseWake = 0.0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Mirrors PlayAOATone, including that the pulse thread's AOA is only updated once the IAS gate is passed
+void TonePipeline::frame(double time, float rawAoa, float ias, bool enabled) {
+    runPulseThread(time);
+
+    float avgAoa = aoaFilter.update(rawAoa);
+    ToneState tone = computeToneState(avgAoa, ias, zoneThresholds, toneSettings);
+    if (tone.zone != lastZone) {
+        listener->zoneChanged(time, lastZone, tone.zone, avgAoa);
+        lastZone = tone.zone;
+    }
+
+    audioEnabled = enabled;
+    if (!audioEnabled || tone.zone == ToneZone::BelowIAS) {
+        shouldPlay = false;
+        listener->silence(time);
+        return;
+    }
+
+    currentAoa = avgAoa;
+
+    if (tone.zone == ToneZone::BelowLDMax) {
+        shouldPlay = false;
+        listener->silence(time);
+    } else if (tone.zone == ToneZone::OnSpeed) {
+        shouldPlay = false;
+        listener->steadyTone(time);
+    } else {
+        shouldPlay = true;
+    }
+}
+
+void TonePipeline::finish(double time) {
+    runPulseThread(time);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Mirrors PulseThreadFunction. Each wake sees the state left by the last frame before it.
+void TonePipeline::runPulseThread(double until) {
+    while (pulseWake <= until) {
+        if (!audioEnabled || !shouldPlay) {
+            pulseWake += PULSE_IDLE_SECONDS;
+            continue;
+        }
+
+        ToneState tone = computeToneState(currentAoa, zoneThresholds, toneSettings);
+        if (!isPulsingZone(tone.zone)) {
+            pulseWake += PULSE_IDLE_SECONDS;
+            continue;
+        }
+
+        listener->pulse(pulseWake, tone.frequency, tone.pulseRate);
+        pulseWake += static_cast<int>(1000.0f / tone.pulseRate) / 1000.0;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef TONE_PIPELINE_H
+#define TONE_PIPELINE_H
+
+#include "aoa_engine.h"
+
+#define PULSE_IDLE_SECONDS      0.05    // The pulse thread's PulseSleep(50) when there is nothing to play
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// What the pipeline asks of the audio source, in time order. Every callback is optional.
+class TonePipelineListener {
+public:
+    virtual ~TonePipelineListener() {}
+
+    // The frame's zone differs from the previous frame's
+    virtual void zoneChanged(double time, ToneZone from, ToneZone to, float avgAoa) {}
+
+    // The pulse thread starts one non-looping pulse, switching buffers if frequency changed since the last one
+    virtual void pulse(double time, float frequency, float pulseRate) {}
+
+    // The flight loop loops the source for OnSpeed, starting it if it isn't already playing
+    virtual void steadyTone(double time) {}
+
+    // The flight loop stops the source: sound off, below IAS or below L/Dmax
+    virtual void silence(double time) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Offline model of the plugin's audio path, for replaying recordings faster than real time.
+// frame() does what PlayAOATone does each flight loop (spike filter, moving average, zone, the shared state
+// handed to the pulse thread), and the pulse thread's loop is stepped on a virtual clock between frames, with
+// the same 50 ms idle sleep and whole-millisecond pulse period as PulseThreadFunction. Nothing sleeps and
+// nothing allocates, so the speed is bounded only by the filter and the listener.
+// Pass the tone settings the plugin would run with, e.g. the aircraft profile's, or the pulse rates and
+// frequencies won't match what it plays.
+class TonePipeline {
+public:
+    TonePipeline(const AoaThresholds& thresholds, const ToneSettings& tone, TonePipelineListener* listener,
+                 int filterWindow = AOA_HISTORY_SIZE, float spikeLimit = MAX_AOA_CHANGE);
+
+    // Start over as if the plugin had just loaded, with the pulse thread waking at time 0
+    void reset();
+
+    // One flight loop at time seconds. Pulses due up to then are emitted first.
+    void frame(double time, float rawAoa, float ias, bool audioEnabled);
+
+    // Let the pulse thread run on to time with no more frames, e.g. at the end of a recording
+    void finish(double time);
+
+    const AoaFilter& filter() const { return aoaFilter; }
+    const AoaThresholds& thresholds() const { return zoneThresholds; }
+    const ToneSettings& tone() const { return toneSettings; }
+    ToneZone zone() const { return lastZone; }
+
+private:
+    void runPulseThread(double until);
+
+    AoaThresholds zoneThresholds;
+    ToneSettings toneSettings;
+    TonePipelineListener* listener;
+    AoaFilter aoaFilter;
+    ToneZone lastZone;
+
+    // What the flight loop shares with the pulse thread
+    bool audioEnabled;
+    bool shouldPlay;
+    float currentAoa;
+
+    double pulseWake;       // when the pulse thread next runs
+};
+
+#endif // TONE_PIPELINE_H
@@ -0,0 +1,168 @@
+#include "tone_renderer.h"
+#include "aoa_engine.h"
+#include "logger.h"
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Success is read back from the buffer rather than alGetError, which is shared with the pulse thread's calls
+static bool uploadTone(ALuint buffer, float frequency) {
+    std::vector<int16_t> tone = generateTone(frequency, TONE_BUFFER_SECONDS, TONE_SAMPLE_RATE);
+    ALsizei bytes = static_cast<ALsizei>(tone.size() * sizeof(ALshort));
+    AL_CHECKED(alBufferData(buffer, AL_FORMAT_MONO16, tone.data(), bytes, TONE_SAMPLE_RATE));
+    ALint size = 0;
+    AL_CHECKED(alGetBufferi(buffer, AL_SIZE, &size));
+    return size == bytes;
+}
+
+static void deleteBuffers(const ToneBuffers& buffers) {
+    AL_CHECKED(alDeleteBuffers(1, &buffers.normal));
+    AL_CHECKED(alDeleteBuffers(1, &buffers.high));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+ToneRenderer::ToneRenderer()
+    : running(false),
+      requestPending(false),
+      requestNormal(0.0f),
+      requestHigh(0.0f),
+      requestGeneration(0),
+      rendered(),
+      renderedReady(false),
+      retired(),
+      retiredCount(0) {
+}
+
+ToneRenderer::~ToneRenderer() {
+    stop();
+}
+
+bool ToneRenderer::render(float normalFrequency, float highFrequency, ToneBuffers& buffers) {
+    ALuint names[2] = {0, 0};
+    AL_CHECKED(alGenBuffers(2, names));
+    if (!names[0] || !names[1] || !alIsBuffer(names[0]) || !alIsBuffer(names[1])) {
+        return false;
+    }
+
+    buffers = ToneBuffers{names[0], names[1], normalFrequency, highFrequency};
+    if (!uploadTone(buffers.normal, normalFrequency) || !uploadTone(buffers.high, highFrequency)) {
+        deleteBuffers(buffers);
+        return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ToneRenderer::request(float normalFrequency, float highFrequency) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestNormal = normalFrequency;
+        requestHigh = highFrequency;
+        requestGeneration++;
+        requestPending = true;
+        if (!running) {
+            running = true;
+            worker = std::thread(&ToneRenderer::threadFunction, this);
+        }
+    }
+    wake.notify_one();
+}
+
+bool ToneRenderer::take(ToneBuffers& buffers) {
+    if (!renderedReady.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers = rendered;
+    renderedReady.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ToneRenderer::retire(const ToneBuffers& buffers, ALuint attached) {
+    for (ALuint buffer : {buffers.normal, buffers.high}) {
+        if (retiredCount == TONE_RETIRED_MAX) {
+            // Only one buffer can be attached, so this means collectRetired() isn't being called. Make room
+            // with the first one that isn't attached; deleting that one would be an AL error and a dropout.
+            LOG_WARNING("Too many tone buffers waiting to be deleted");
+            int victim = retired[0] == attached ? 1 : 0;
+            AL_CHECKED(alDeleteBuffers(1, &retired[victim]));
+            retired[victim] = retired[--retiredCount];
+        }
+        retired[retiredCount++] = buffer;
+    }
+}
+
+void ToneRenderer::collectRetired(ALuint attached) {
+    int kept = 0;
+    for (int i = 0; i < retiredCount; i++) {
+        if (retired[i] == attached) {
+            retired[kept++] = retired[i];
+        } else {
+            AL_CHECKED(alDeleteBuffers(1, &retired[i]));
+        }
+    }
+    retiredCount = kept;
+}
+
+void ToneRenderer::deleteRetired() {
+    collectRetired(0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ToneRenderer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_all();
+    worker.join();
+
+    if (renderedReady.exchange(false)) {
+        deleteBuffers(rendered);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A render that was overtaken by a newer request, or wasn't taken before the next one finished, is deleted here
+void ToneRenderer::threadFunction() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return !running || requestPending; });
+        if (!running) {
+            return;
+        }
+
+        float normalFrequency = requestNormal;
+        float highFrequency = requestHigh;
+        unsigned generation = requestGeneration;
+        requestPending = false;
+        lock.unlock();
+
+        ToneBuffers buffers;
+        bool ok = render(normalFrequency, highFrequency, buffers);
+        if (!ok) {
+            LOG_ERROR("Failed to render %.0f / %.0f Hz tones", normalFrequency, highFrequency);
+        }
+
+        lock.lock();
+        if (ok && (generation != requestGeneration || !running)) {
+            deleteBuffers(buffers);
+        } else if (ok) {
+            if (renderedReady.load(std::memory_order_relaxed)) {
+                deleteBuffers(rendered);
+            }
+            rendered = buffers;
+            renderedReady.store(true, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef TONE_RENDERER_H
+#define TONE_RENDERER_H
+
+#include "al_check.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define TONE_BUFFER_SECONDS     0.1f    // Length of each tone buffer, one pulse
+#define TONE_SAMPLE_RATE        44100
+#define TONE_RETIRED_MAX        8       // Swapped out buffers waiting to be deleted
+
+// The pair of AL buffers the source plays from, and the frequencies they hold
+struct ToneBuffers {
+    ALuint normal;
+    ALuint high;
+    float normalFrequency;
+    float highFrequency;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Renders tone buffers for new frequencies on a background thread, so editing a frequency never stalls the sim
+// or silences the tone. The sine waves are generated and uploaded into fresh AL buffers while the source keeps
+// playing the old ones; the sim thread then takes the new pair and swaps it in. A buffer still attached to the
+// source can't be deleted, so swapped out buffers are retired and deleted by collectRetired() once the source
+// has moved off them. Only the newest request is rendered to completion.
+class ToneRenderer {
+public:
+    ToneRenderer();
+    ~ToneRenderer();
+
+    // Render on the calling thread, for audio init. Returns false if the AL buffers couldn't be made.
+    static bool render(float normalFrequency, float highFrequency, ToneBuffers& buffers);
+
+    // Sim thread. Queue a render, replacing any that hasn't finished. Starts the thread the first time.
+    void request(float normalFrequency, float highFrequency);
+
+    // Sim thread. True, once, when a requested render has finished.
+    bool take(ToneBuffers& buffers);
+
+    // Sim thread. Hand over buffers that have been swapped out. attached is the buffer the source has now,
+    // which is never deleted to make room.
+    void retire(const ToneBuffers& buffers, ALuint attached);
+    bool hasRetired() const { return retiredCount > 0; }
+
+    // Sim thread. Delete every retired buffer except the one the source has attached.
+    void collectRetired(ALuint attached);
+
+    // Stop the thread and delete a finished render nobody took. Call before the AL context goes.
+    void stop();
+
+    // Delete all retired buffers, once the source is gone
+    void deleteRetired();
+
+private:
+    void threadFunction();
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+
+    // Guarded by mutex
+    bool requestPending;
+    float requestNormal;
+    float requestHigh;
+    unsigned requestGeneration;
+    ToneBuffers rendered;
+
+    std::atomic<bool> renderedReady;
+
+    // Sim thread only
+    ALuint retired[TONE_RETIRED_MAX];
+    int retiredCount;
+};
+
+#endif // TONE_RENDERER_H
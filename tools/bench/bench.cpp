@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Micro benchmarks for the per-frame engine code, reported as JSON so runs can be compared across releases.
+//
+//   bench                          run everything, JSON on stdout
+//   bench --filter frame --min-time 2 --out bench.json
+//
+// Every benchmark reports ns/op and heap allocations/op. Allocations are counted by replacing the global
+// operator new (alloc_counter.h). Benchmarks marked steady_state cover code that runs every frame on the sim thread; if any of
+// them allocates the run exits with status 2.
+
+#include "alloc_counter.h"
+#include "aoa_engine.h"
+#include "frame_cost.h"
+#include "scope_buffer.h"
+#include "ui_text.h"
+#include "version.h"
+#include "flight_profile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Recorded flight the benchmarks cycle through, a power of two long so the index is a mask
+const int INPUT_SIZE = 4096;
+
+struct BenchInput {
+    float aoa[INPUT_SIZE];
+    float ias[INPUT_SIZE];
+};
+
+struct BenchResult {
+    std::string name;
+    bool steadyState;
+    long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+struct BenchOptions {
+    double minTime = 0.5;       // seconds per benchmark
+    const char* filter = nullptr;
+};
+
+// Written by every benchmark so the compiler can't drop the work
+volatile float floatSink;
+volatile char charSink;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// An approach with sensor spikes, so the filter and every zone get exercised
+void makeInput(BenchInput& input) {
+    FlightProfileOptions options;
+    options.maneuver = FlightManeuver::SensorSpikes;
+    options.seed = 1;
+    options.seconds = FlightProfile::maneuverSeconds(options.maneuver);
+    options.fps = INPUT_SIZE / static_cast<float>(options.seconds) * 1.01f;
+    FlightProfile profile(options);
+
+    FlightSample sample = {};
+    for (int i = 0; i < INPUT_SIZE; i++) {
+        profile.next(sample);
+        input.aoa[i] = sample.aoa;
+        input.ias[i] = sample.ias;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Run op(i) in growing batches until minTime has passed. One untimed batch warms caches and lets any lazy
+// one-time allocation happen before counting starts.
+template <typename Op>
+void runBench(const char* name, bool steadyState, const BenchOptions& options, std::vector<BenchResult>& results,
+              Op op) {
+    if (options.filter && !strstr(name, options.filter)) {
+        return;
+    }
+
+    long long i = 0;
+    for (long long end = i + 1000; i < end; i++) {
+        op(i);
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    long long batch = 1;
+    long long iterations = 0;
+    double seconds = 0.0;
+    long long allocsBefore = allocationCount();
+
+    while (seconds < options.minTime) {
+        Clock::time_point start = Clock::now();
+        for (long long end = i + batch; i < end; i++) {
+            op(i);
+        }
+        double batchSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        seconds += batchSeconds;
+        iterations += batch;
+        if (batchSeconds < 0.01 && batch < (1LL << 30)) {
+            batch *= 2;
+        }
+    }
+
+    long long allocs = allocationCount() - allocsBefore;
+    results.push_back(BenchResult{name, steadyState, iterations, 1.0e9 * seconds / iterations,
+                                  static_cast<double>(allocs) / iterations});
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void writeJson(FILE* file, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    fprintf(file, "{\n");
+    fprintf(file, "  \"version\": \"%s\",\n", FLYONSPEED_VERSION);
+    fprintf(file, "  \"min_time_s\": %g,\n", options.minTime);
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"steady_state\": %s, \"iterations\": %lld, "
+                      "\"ns_per_op\": %.3f, \"allocs_per_op\": %.6f}%s\n",
+                r.name.c_str(), r.steadyState ? "true" : "false", r.iterations, r.nsPerOp, r.allocsPerOp,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void usage() {
+    fprintf(stderr,
+        "usage: bench [options]\n"
+        "  --min-time S     seconds to run each benchmark (default 0.5)\n"
+        "  --filter TEXT    only run benchmarks whose name contains TEXT\n"
+        "  --out FILE       write the JSON report to FILE instead of stdout\n");
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv) {
+    BenchOptions options;
+    const char* outPath = nullptr;
+    setCountAllocations(true);
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--min-time") && hasValue) {
+            options.minTime = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--filter") && hasValue) {
+            options.filter = argv[++i];
+        } else if (!strcmp(argv[i], "--out") && hasValue) {
+            outPath = argv[++i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (options.minTime <= 0.0) {
+        usage();
+        return 1;
+    }
+
+    static BenchInput input;
+    makeInput(input);
+
+    const AoaThresholds thresholds = defaultAoaThresholds();
+    const int mask = INPUT_SIZE - 1;
+    std::vector<BenchResult> results;
+    results.reserve(16);
+
+    // Startup: the two tone buffers are rendered once when the plugin loads
+    runBench("generate_tone_100ms", false, options, results, [&](long long i) {
+        std::vector<int16_t> tone = generateTone(i & 1 ? TONE_HIGH_FREQ : TONE_NORMAL_FREQ, 0.1f);
+        floatSink = tone[tone.size() / 2];
+    });
+
+    // PlayAOATone: spike filter and moving average
+    AoaFilter filter;
+    runBench("aoa_filter_update", true, options, results, [&](long long i) {
+        floatSink = filter.update(input.aoa[i & mask]);
+    });
+
+    // PlayAOATone: filter then zone, frequency and pulse rate with the IAS gate
+    filter.reset();
+    runBench("frame_filter_zone", true, options, results, [&](long long i) {
+        float avgAoa = filter.update(input.aoa[i & mask]);
+        ToneState tone = computeToneState(avgAoa, input.ias[i & mask], thresholds);
+        floatSink = isPulsingZone(tone.zone) ? tone.pulseRate : tone.frequency;
+    });
+
+    // PulseThreadFunction: zone to (frequency, pps) and the sleep that follows from it
+    runBench("pulse_zone_mapping", true, options, results, [&](long long i) {
+        ToneState tone = computeToneState(input.aoa[i & mask], thresholds);
+        if (isPulsingZone(tone.zone)) {
+            floatSink = tone.frequency + static_cast<float>(static_cast<int>(1000.0f / tone.pulseRate));
+        }
+    });
+
+    // CheckAOAAndPlayTone: frame cost accounting, fed with made up 1 to 9 us timings at 60 fps
+    FrameCostStats frameCost;
+    runBench("frame_cost_add", true, options, results, [&](long long i) {
+        floatSink = frameCost.add(1000 + (i * 7919) % 8000, 1.0f / 60.0f) ? frameCost.summary().p99Us : 0.0f;
+    });
+    const FrameCostSummary cost = frameCost.summary();
+
+    // UiPresenter: the live captions
+    char text[64];
+    runBench("format_aoa_text", true, options, results, [&](long long i) {
+        LiveFrame frame = {input.aoa[i & mask], input.aoa[(i + 1) & mask], input.ias[i & mask], true,
+                           ToneState{ToneZone::OnSpeed, 0.0f, 0.0f}, cost};
+        formatAoaText(text, sizeof(text), frame);
+        charSink = text[5];
+    });
+
+    runBench("format_audio_status_text", true, options, results, [&](long long i) {
+        LiveFrame frame = {input.aoa[i & mask], input.aoa[i & mask], input.ias[i & mask], true,
+                           computeToneState(input.aoa[i & mask], input.ias[i & mask], thresholds), cost};
+        formatAudioStatusText(text, sizeof(text), frame, thresholds);
+        charSink = text[7];
+    });
+
+    runBench("format_frame_cost_text", true, options, results, [&](long long i) {
+        LiveFrame frame = {0.0f, 0.0f, 0.0f, true, ToneState{ToneZone::OnSpeed, 0.0f, 0.0f}, cost};
+        frame.frameCost.maxUs += static_cast<float>(i & 7);
+        formatFrameCostText(text, sizeof(text), frame);
+        charSink = text[7];
+    });
+
+    // ScopeWindow: a 500 pixel wide draw of the last 10 s, from a buffer a minute of 60 fps frames deep
+    static ScopeBuffer scope;
+    for (int i = 0; i < SCOPE_CAPACITY; i++) {
+        scope.push(ScopeSample{i / 60.0, input.aoa[i & mask], input.aoa[(i + 1) & mask], 0, 0});
+    }
+    static ScopeColumn columns[SCOPE_COLUMNS_MAX];
+    runBench("scope_decimate_500", true, options, results, [&](long long i) {
+        floatSink = static_cast<float>(scope.decimate(10.0, 500, columns)) + columns[i & 255].avgMax;
+    });
+
+    // Everything the flight loop does in one frame with the window open, minus the XPLM and OpenAL calls
+    filter.reset();
+    runBench("frame_full", true, options, results, [&](long long i) {
+        float avgAoa = filter.update(input.aoa[i & mask]);
+        LiveFrame frame = {filter.lastSample(), avgAoa, input.ias[i & mask], true,
+                           computeToneState(avgAoa, input.ias[i & mask], thresholds), cost};
+        scope.push(ScopeSample{i / 60.0, input.aoa[i & mask], avgAoa, static_cast<uint8_t>(frame.tone.zone), 0});
+        formatAoaText(text, sizeof(text), frame);
+        formatAudioStatusText(text, sizeof(text), frame, thresholds);
+        formatFrameCostText(text, sizeof(text), frame);
+        frameCost.add(1000 + (i & 4095), 1.0f / 60.0f);
+        charSink = text[7];
+    });
+
+    FILE* file = outPath ? fopen(outPath, "w") : stdout;
+    if (!file) {
+        fprintf(stderr, "Can't write %s\n", outPath);
+        return 1;
+    }
+    writeJson(file, options, results);
+    if (file != stdout) {
+        fclose(file);
+    }
+
+    int status = 0;
+    for (const BenchResult& r : results) {
+        if (r.steadyState && r.allocsPerOp > 0.0) {
+            fprintf(stderr, "%s allocates %.6f times per op on the per-frame path\n", r.name.c_str(), r.allocsPerOp);
+            status = 2;
+        }
+    }
+    return status;
+}
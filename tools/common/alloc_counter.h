@@ -0,0 +1,17 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Heap allocation counting for the tools that check the per-frame code never allocates.
+// Linking this in replaces the global operator new and delete for the whole process, plugins it loads included.
+// Only allocations on threads that have turned counting on are counted, so threads that are allowed to
+// allocate can be left out.
+
+// Count allocations made on the calling thread from now on, or stop counting them
+void setCountAllocations(bool count);
+
+// Allocations counted so far, over every thread
+long long allocationCount();
+
+#endif // ALLOC_COUNTER_H
@@ -0,0 +1,231 @@
+#include "flight_profile.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Model aircraft, roughly an RV at light weight
+const float STALL_AOA = 15.0f;                  // clean critical AOA, degrees
+const float STALL_IAS = 55.0f;                  // clean 1 G stall speed, knots
+const float ZERO_LIFT_AOA = -2.0f;              // clean
+const float FULL_FLAP_AOA_SHIFT = -4.0f;        // full flaps lower the zero lift AOA by this much
+const float LIFT_K = (STALL_AOA - ZERO_LIFT_AOA) * STALL_IAS * STALL_IAS;
+
+// Sensor noise on every sample
+const float AOA_NOISE = 0.05f;                  // degrees, 1 sigma
+const float IAS_NOISE = 0.2f;                   // knots, 1 sigma
+
+const float DEG_PER_RAD = 57.29578f;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Linear ramp from a to b as t goes from t0 to t1, held outside that range
+float ramp(double t, double t0, double t1, float a, float b) {
+    if (t <= t0) return a;
+    if (t >= t1) return b;
+    return a + static_cast<float>((t - t0) / (t1 - t0)) * (b - a);
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FlightProfile::FlightProfile(const FlightProfileOptions& options)
+    : options(options),
+      duration(options.seconds > 0.0 ? options.seconds : maneuverSeconds(options.maneuver)),
+      time(0.0),
+      rng(options.seed),
+      unitNormal(0.0f, 1.0f),
+      unitUniform(-1.0f, 1.0f),
+      gustVertical(0.0f),
+      gustHorizontal(0.0f),
+      spikeFramesLeft(0),
+      spikeAoa(0.0f) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool FlightProfile::next(FlightSample& sample) {
+    float elapsed = 1.0f / options.fps;
+    if (options.jitter > 0.0f) {
+        elapsed *= 1.0f + options.jitter * unitUniform(rng);
+    }
+    if (time + elapsed > duration) {
+        return false;
+    }
+    time += elapsed;
+
+    sample.time = time;
+    sample.elapsed = elapsed;
+    sample.gLoad = 1.0f;
+    sample.flapRatio = 0.0f;
+
+    double t = std::fmod(time, maneuverSeconds(options.maneuver));
+    switch (options.maneuver) {
+        case FlightManeuver::Approach:
+        case FlightManeuver::SensorSpikes:
+            approach(t, sample);
+            break;
+        case FlightManeuver::PowerOffStall:
+            powerOffStall(t, sample);
+            break;
+        case FlightManeuver::SteepTurns:
+            steepTurns(t, sample);
+            break;
+        case FlightManeuver::Turbulence:
+            sample.ias = 75.0f;
+            sample.flapRatio = 0.5f;
+            sample.aoa = modelAoa(sample.ias, sample.gLoad, sample.flapRatio);
+            turbulence(elapsed, sample);
+            break;
+    }
+
+    sample.aoa += AOA_NOISE * unitNormal(rng);
+    sample.ias += IAS_NOISE * unitNormal(rng);
+
+    if (options.maneuver == FlightManeuver::SensorSpikes) {
+        addSpikes(sample);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+float FlightProfile::modelAoa(float ias, float gLoad, float flapRatio) {
+    if (ias < 1.0f) {
+        ias = 1.0f;
+    }
+    return ZERO_LIFT_AOA + flapRatio * FULL_FLAP_AOA_SHIFT + gLoad * LIFT_K / (ias * ias);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 90 s: slow from 90 to 70 kt with flaps going to half then full, settle at 65 kt, then flare
+void FlightProfile::approach(double t, FlightSample& sample) {
+    sample.flapRatio = t < 40.0 ? ramp(t, 20.0, 23.0, 0.0f, 0.5f) : ramp(t, 45.0, 48.0, 0.5f, 1.0f);
+    sample.ias = t < 80.0 ? (t < 50.0 ? ramp(t, 0.0, 50.0, 90.0f, 70.0f) : ramp(t, 50.0, 80.0, 70.0f, 65.0f))
+                          : ramp(t, 80.0, 90.0, 65.0f, 55.0f);
+    sample.gLoad = 1.0f + 0.05f * static_cast<float>(std::sin(0.5 * t)) + ramp(t, 82.0, 86.0, 0.0f, 0.15f);
+    sample.aoa = modelAoa(sample.ias, sample.gLoad, sample.flapRatio);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 70 s: level at 80 kt, slow at 1 kt/s until a degree past the critical AOA, break, then recover
+void FlightProfile::powerOffStall(double t, FlightSample& sample) {
+    const double decelStart = 10.0;
+    const float breakIas = std::sqrt(LIFT_K / (STALL_AOA + 1.0f - ZERO_LIFT_AOA));
+    const double breakTime = decelStart + (80.0f - breakIas);
+
+    if (t < breakTime) {
+        sample.ias = ramp(t, decelStart, breakTime, 80.0f, breakIas);
+        sample.gLoad = 1.0f;
+    } else if (t < breakTime + 3.0) {
+        // Nose drops: unloads, speed keeps bleeding for a moment
+        sample.ias = ramp(t, breakTime, breakTime + 3.0, breakIas, breakIas + 3.0f);
+        sample.gLoad = ramp(t, breakTime, breakTime + 1.0, 1.0f, 0.6f);
+    } else {
+        // Dive and pull out
+        sample.ias = ramp(t, breakTime + 3.0, breakTime + 10.0, breakIas + 3.0f, 80.0f);
+        sample.gLoad = t < breakTime + 10.0 ? ramp(t, breakTime + 3.0, breakTime + 5.0, 0.6f, 1.4f)
+                                            : ramp(t, breakTime + 10.0, breakTime + 12.0, 1.4f, 1.0f);
+    }
+    sample.aoa = modelAoa(sample.ias, sample.gLoad, 0.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 60 s: roll into a 60 degree bank, hold 30 s losing a little speed, roll out
+void FlightProfile::steepTurns(double t, FlightSample& sample) {
+    float bank = t < 40.0 ? ramp(t, 5.0, 10.0, 0.0f, 60.0f) : ramp(t, 40.0, 45.0, 60.0f, 0.0f);
+    sample.gLoad = 1.0f / std::cos(bank / DEG_PER_RAD);
+    sample.ias = t < 40.0 ? ramp(t, 10.0, 40.0, 100.0f, 92.0f) : ramp(t, 45.0, 60.0, 92.0f, 100.0f);
+    sample.aoa = modelAoa(sample.ias, sample.gLoad, 0.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// First order filtered noise for vertical and horizontal gusts. A vertical gust w changes the AOA by
+// atan(w / V), and at a fixed speed the load factor follows the change in AOA.
+void FlightProfile::turbulence(float elapsed, FlightSample& sample) {
+    const float tau = 1.5f;             // seconds
+    const float sigmaVertical = 8.0f;   // kt
+    const float sigmaHorizontal = 5.0f;
+
+    float a = std::exp(-elapsed / tau);
+    float b = std::sqrt(1.0f - a * a);
+    gustVertical = a * gustVertical + b * sigmaVertical * unitNormal(rng);
+    gustHorizontal = a * gustHorizontal + b * sigmaHorizontal * unitNormal(rng);
+
+    float baseAoa = sample.aoa;
+    float liftAoa = baseAoa - (ZERO_LIFT_AOA + sample.flapRatio * FULL_FLAP_AOA_SHIFT);
+    sample.ias += gustHorizontal;
+    sample.aoa += std::atan2(gustVertical, sample.ias) * DEG_PER_RAD;
+    sample.gLoad = (liftAoa + sample.aoa - baseAoa) / liftAoa;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// About one AOA spike every two seconds lasting 1 to 3 frames, and an occasional single frame IAS dropout
+void FlightProfile::addSpikes(FlightSample& sample) {
+    float perFrame = sample.elapsed * 0.5f;
+    if (spikeFramesLeft == 0 && (unitUniform(rng) + 1.0f) * 0.5f < perFrame) {
+        spikeFramesLeft = 1 + static_cast<int>((unitUniform(rng) + 1.0f) * 1.5f);
+        float magnitude = 8.0f + 8.5f * (unitUniform(rng) + 1.0f);
+        spikeAoa = unitUniform(rng) < 0.0f ? -magnitude : magnitude;
+    }
+    if (spikeFramesLeft > 0) {
+        sample.aoa += spikeAoa;
+        spikeFramesLeft--;
+    }
+
+    if ((unitUniform(rng) + 1.0f) * 0.5f < perFrame * 0.2f) {
+        sample.ias = 0.0f;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double FlightProfile::maneuverSeconds(FlightManeuver maneuver) {
+    switch (maneuver) {
+        case FlightManeuver::Approach:      return 90.0;
+        case FlightManeuver::PowerOffStall: return 70.0;
+        case FlightManeuver::SteepTurns:    return 60.0;
+        case FlightManeuver::Turbulence:    return 120.0;
+        case FlightManeuver::SensorSpikes:  return 90.0;
+    }
+    return 60.0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static const struct {
+    FlightManeuver maneuver;
+    const char* name;
+} MANEUVER_NAMES[] = {
+    {FlightManeuver::Approach,      "approach"},
+    {FlightManeuver::PowerOffStall, "stall"},
+    {FlightManeuver::SteepTurns,    "turns"},
+    {FlightManeuver::Turbulence,    "turbulence"},
+    {FlightManeuver::SensorSpikes,  "spikes"},
+};
+
+bool FlightProfile::parseManeuver(const char* name, FlightManeuver& maneuver) {
+    for (const auto& entry : MANEUVER_NAMES) {
+        if (!strcmp(entry.name, name)) {
+            maneuver = entry.maneuver;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* FlightProfile::maneuverName(FlightManeuver maneuver) {
+    for (const auto& entry : MANEUVER_NAMES) {
+        if (entry.maneuver == maneuver) {
+            return entry.name;
+        }
+    }
+    return "?";
+}
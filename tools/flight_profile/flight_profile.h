@@ -0,0 +1,86 @@
+#ifndef FLIGHT_PROFILE_H
+#define FLIGHT_PROFILE_H
+
+#include <random>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Synthetic AOA/IAS/G/flap time series for load and regression runs.
+// Samples are generated one frame at a time with nothing stored, so a run can be as long as you like, and the
+// same seed always gives the same series. Each maneuver repeats once it finishes.
+//
+// AOA comes from a simple lift model: AOA = zeroLiftAOA + G * K / IAS^2, with K chosen so the clean wing
+// stalls at 15 degrees and 55 kt. Flaps lower the zero lift AOA. Gusts and sensor noise are added on top.
+
+// Datarefs the samples map to when scripting the host
+#define FLIGHT_PROFILE_AOA_DATAREF     "sim/flightmodel/position/alpha"
+#define FLIGHT_PROFILE_IAS_DATAREF     "sim/flightmodel/position/indicated_airspeed"
+#define FLIGHT_PROFILE_G_DATAREF       "sim/flightmodel/forces/g_nrml"
+#define FLIGHT_PROFILE_FLAP_DATAREF    "sim/cockpit2/controls/flap_ratio"
+
+enum class FlightManeuver {
+    Approach,           // decelerate, flaps in stages, flare
+    PowerOffStall,      // 1 kt/s decel to the break, then recover
+    SteepTurns,         // 60 degree bank turns at constant power
+    Turbulence,         // gusty air at approach speed
+    SensorSpikes,       // approach with AOA spikes and IAS dropouts
+};
+
+struct FlightProfileOptions {
+    FlightManeuver maneuver = FlightManeuver::Approach;
+    float fps = 60.0f;
+    float jitter = 0.0f;        // frame time varies by up to this fraction either way
+    unsigned seed = 1;
+    double seconds = 0.0;       // 0 runs one pass of the maneuver
+};
+
+struct FlightSample {
+    double time;                // seconds since the start
+    float elapsed;              // frame time that led to this sample
+    float aoa;                  // degrees, as the sensor reports it
+    float ias;                  // knots
+    float gLoad;
+    float flapRatio;            // 0 up to 1 full
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class FlightProfile {
+public:
+    explicit FlightProfile(const FlightProfileOptions& options);
+
+    // Produce the next frame. Returns false once the requested duration is over.
+    bool next(FlightSample& sample);
+
+    // Length of one pass of a maneuver in seconds
+    static double maneuverSeconds(FlightManeuver maneuver);
+
+    // Parse a maneuver name such as "approach" or "stall". Returns false if it isn't one.
+    static bool parseManeuver(const char* name, FlightManeuver& maneuver);
+    static const char* maneuverName(FlightManeuver maneuver);
+
+    // AOA the model wing flies at for an airspeed, load factor and flap setting
+    static float modelAoa(float ias, float gLoad, float flapRatio);
+
+private:
+    void approach(double t, FlightSample& sample);
+    void powerOffStall(double t, FlightSample& sample);
+    void steepTurns(double t, FlightSample& sample);
+    void turbulence(float elapsed, FlightSample& sample);
+    void addSpikes(FlightSample& sample);
+
+    FlightProfileOptions options;
+    double duration;
+    double time;
+
+    std::mt19937 rng;
+    std::normal_distribution<float> unitNormal;
+    std::uniform_real_distribution<float> unitUniform;
+
+    float gustVertical;         // kt, low pass filtered noise
+    float gustHorizontal;
+    int spikeFramesLeft;
+    float spikeAoa;
+};
+
+#endif // FLIGHT_PROFILE_H
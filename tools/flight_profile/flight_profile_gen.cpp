@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Generate a synthetic flight and either write it as a host script or run it straight through the engine.
+//
+//   flight_profile_gen approach --fps 60 --jitter 0.2 --seed 7 --csv approach.csv
+//   flight_profile_gen turbulence --seconds 36000 --engine
+//
+// The CSV has the same columns xplm_host_run --script expects.
+
+#include "flight_profile.h"
+#include "aoa_engine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void usage() {
+    fprintf(stderr,
+        "usage: flight_profile_gen <approach|stall|turns|turbulence|spikes> [options]\n"
+        "  --fps N          frame rate (default 60)\n"
+        "  --jitter F       frame time varies by up to this fraction (default 0)\n"
+        "  --seed N         random seed (default 1)\n"
+        "  --seconds S      length, the maneuver repeats (default one pass)\n"
+        "  --csv FILE       write the samples as a host script, - for stdout (the default)\n"
+        "  --engine         run the samples through the AOA filter and zone logic and print a summary\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static int writeCsv(FlightProfile& profile, const char* path) {
+    FILE* file = strcmp(path, "-") ? fopen(path, "w") : stdout;
+    if (!file) {
+        fprintf(stderr, "Can't write %s\n", path);
+        return 1;
+    }
+
+    fprintf(file, "time,%s,%s,%s,%s\n", FLIGHT_PROFILE_AOA_DATAREF, FLIGHT_PROFILE_IAS_DATAREF,
+            FLIGHT_PROFILE_G_DATAREF, FLIGHT_PROFILE_FLAP_DATAREF);
+    FlightSample sample;
+    while (profile.next(sample)) {
+        fprintf(file, "%.4f,%.3f,%.2f,%.3f,%.3f\n", sample.time, sample.aoa, sample.ias, sample.gLoad, sample.flapRatio);
+    }
+
+    if (file != stdout) {
+        fclose(file);
+    }
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Same filter -> zone steps PlayAOATone takes each frame, with the default thresholds
+static int runEngine(FlightProfile& profile) {
+    const int zoneCount = static_cast<int>(ToneZone::Stall) + 1;
+    double zoneSeconds[zoneCount] = {};
+    long long frames = 0;
+    long long transitions = 0;
+    long long spikes = 0;
+    double simSeconds = 0.0;
+
+    AoaFilter filter;
+    AoaThresholds thresholds = defaultAoaThresholds();
+    ToneZone lastZone = ToneZone::BelowIAS;
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    FlightSample sample;
+    while (profile.next(sample)) {
+        float avgAoa = filter.update(sample.aoa);
+        ToneState tone = computeToneState(avgAoa, sample.ias, thresholds);
+
+        frames++;
+        simSeconds += sample.elapsed;
+        zoneSeconds[static_cast<int>(tone.zone)] += sample.elapsed;
+        if (filter.lastWasSpike()) {
+            spikes++;
+        }
+        if (frames > 1 && tone.zone != lastZone) {
+            transitions++;
+        }
+        lastZone = tone.zone;
+    }
+
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+
+    printf("frames: %lld  simulated: %.1f s  wall: %.1f ms  (%.0fx real time)\n",
+           frames, simSeconds, wallMs, wallMs > 0.0 ? 1000.0 * simSeconds / wallMs : 0.0);
+    printf("zone transitions: %lld  spikes rejected: %lld\n", transitions, spikes);
+    for (int i = 0; i < zoneCount; i++) {
+        printf("  %-14s %8.1f s  %5.1f%%\n", toneZoneName(static_cast<ToneZone>(i)), zoneSeconds[i],
+               simSeconds > 0.0 ? 100.0 * zoneSeconds[i] / simSeconds : 0.0);
+    }
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv) {
+    FlightProfileOptions options;
+    if (argc < 2 || !FlightProfile::parseManeuver(argv[1], options.maneuver)) {
+        usage();
+        return 1;
+    }
+
+    const char* csvPath = "-";
+    bool engine = false;
+
+    for (int i = 2; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--fps") && hasValue) {
+            options.fps = static_cast<float>(atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--jitter") && hasValue) {
+            options.jitter = static_cast<float>(atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--seed") && hasValue) {
+            options.seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--seconds") && hasValue) {
+            options.seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--csv") && hasValue) {
+            csvPath = argv[++i];
+        } else if (!strcmp(argv[i], "--engine")) {
+            engine = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (options.fps <= 0.0f || options.jitter < 0.0f || options.jitter >= 1.0f) {
+        usage();
+        return 1;
+    }
+
+    FlightProfile profile(options);
+    return engine ? runEngine(profile) : writeCsv(profile, csvPath);
+}
@@ -0,0 +1,409 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Replays flight recordings (Toggle Recording, .fosrec) through the plugin's filter -> zone -> pulse pipeline
+// as fast as the CPU allows, to see what a changed threshold set or filter would have sounded like over past
+// flights.
+//
+//   tone_replay Output/*.fosrec
+//   tone_replay approach.fosrec --thresholds 6.5,7.8,10,13 --events events.csv --wav approach.wav
+//   tone_replay Output/*.fosrec --profile C172.profile
+//   tone_replay Output/*.fosrec --window 30 --spike-limit 4
+//
+// Prints a summary per recording. --events writes every zone transition and pulse as CSV, --wav renders
+// what the OpenAL source would have played. --profile takes setpoints, filter window and tone settings from an
+// aircraft profile, so the replay pulses and sounds like the plugin flying with it.
+
+#include "aircraft_profile.h"
+#include "aoa_engine.h"
+#include "flight_recorder.h"
+#include "tone_pipeline.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const int SAMPLE_RATE = 44100;
+const int ZONE_COUNT = static_cast<int>(ToneZone::Stall) + 1;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Stands in for the plugin's OpenAL source: the same two 100 ms buffers at the settings' frequencies and
+// volume, restarted by each pulse and looped for OnSpeed, streamed to a 16 bit mono WAV file
+class WavRenderer {
+public:
+    explicit WavRenderer(const ToneSettings& tone)
+        : file(nullptr),
+          toneNormal(generateTone(tone.normalFrequency, 0.1f, SAMPLE_RATE)),
+          toneHigh(generateTone(tone.highFrequency, 0.1f, SAMPLE_RATE)),
+          highFrequency(tone.highFrequency),
+          volume(tone.volume),
+          renderedSamples(0),
+          chunkSize(0) {
+        reset();
+    }
+
+    bool open(const char* path) {
+        file = fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+        writeHeader(0);
+        return true;
+    }
+
+    // Patch the sizes into the header now the length is known
+    void close() {
+        if (!file) {
+            return;
+        }
+        flush();
+        fseek(file, 0, SEEK_SET);
+        writeHeader(static_cast<uint32_t>(renderedSamples * sizeof(int16_t)));
+        fclose(file);
+        file = nullptr;
+    }
+
+    void reset() {
+        buffer = &toneNormal;
+        lastPulseFrequency = 0.0f;
+        playing = false;
+        looping = false;
+        position = 0;
+    }
+
+    void pulse(double time, float frequency) {
+        advance(time);
+        if (frequency != lastPulseFrequency) {
+            lastPulseFrequency = frequency;
+            playing = false;
+            buffer = frequency == highFrequency ? &toneHigh : &toneNormal;
+        }
+        looping = false;
+        play();
+    }
+
+    void steadyTone(double time) {
+        advance(time);
+        looping = true;
+        if (!playing) {
+            play();
+        }
+    }
+
+    void silence(double time) {
+        advance(time);
+        playing = false;
+    }
+
+    // Render up to time seconds of the output
+    void advance(double time) {
+        if (!file) {
+            return;
+        }
+        long long target = static_cast<long long>(time * SAMPLE_RATE);
+        while (renderedSamples < target) {
+            int16_t sample = 0;
+            if (playing) {
+                sample = static_cast<int16_t>((*buffer)[position++] * volume);     // AL_GAIN
+                if (position == buffer->size()) {
+                    position = 0;
+                    playing = looping;
+                }
+            }
+            chunk[chunkSize++] = sample;
+            if (chunkSize == CHUNK_SAMPLES) {
+                flush();
+            }
+            renderedSamples++;
+        }
+    }
+
+private:
+    static const size_t CHUNK_SAMPLES = 4096;
+
+    // alSourcePlay always starts from the beginning of the buffer
+    void play() {
+        playing = true;
+        position = 0;
+    }
+
+    void flush() {
+        fwrite(chunk, sizeof(int16_t), chunkSize, file);
+        chunkSize = 0;
+    }
+
+    void writeHeader(uint32_t dataBytes) {
+        const uint16_t channels = 1;
+        const uint16_t bits = 16;
+        const uint16_t format = 1;     // PCM
+        const uint16_t blockAlign = channels * bits / 8;
+        const uint32_t byteRate = SAMPLE_RATE * blockAlign;
+        const uint32_t sampleRate = SAMPLE_RATE;
+        const uint32_t fmtBytes = 16;
+        const uint32_t riffBytes = 36 + dataBytes;
+
+        fwrite("RIFF", 1, 4, file);
+        fwrite(&riffBytes, 4, 1, file);
+        fwrite("WAVEfmt ", 1, 8, file);
+        fwrite(&fmtBytes, 4, 1, file);
+        fwrite(&format, 2, 1, file);
+        fwrite(&channels, 2, 1, file);
+        fwrite(&sampleRate, 4, 1, file);
+        fwrite(&byteRate, 4, 1, file);
+        fwrite(&blockAlign, 2, 1, file);
+        fwrite(&bits, 2, 1, file);
+        fwrite("data", 1, 4, file);
+        fwrite(&dataBytes, 4, 1, file);
+    }
+
+    FILE* file;
+    std::vector<int16_t> toneNormal;
+    std::vector<int16_t> toneHigh;
+    float highFrequency;
+    float volume;
+    const std::vector<int16_t>* buffer;
+    float lastPulseFrequency;
+    bool playing;
+    bool looping;
+    size_t position;
+    long long renderedSamples;
+    int16_t chunk[CHUNK_SAMPLES];
+    size_t chunkSize;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Counts what the pipeline does and passes it on to the event CSV and the WAV renderer, if any
+class ReplayListener : public TonePipelineListener {
+public:
+    ReplayListener(FILE* events, WavRenderer* audio) : events(events), audio(audio) {}
+
+    void zoneChanged(double time, ToneZone from, ToneZone to, float avgAoa) override {
+        transitions++;
+        if (events) {
+            fprintf(events, "%.4f,zone,%s,%s,,,%.3f\n", time, toneZoneName(from), toneZoneName(to), avgAoa);
+        }
+    }
+
+    void pulse(double time, float frequency, float pulseRate) override {
+        pulses++;
+        if (events) {
+            fprintf(events, "%.4f,pulse,,,%.0f,%.2f,\n", time, frequency, pulseRate);
+        }
+        if (audio) {
+            audio->pulse(time, frequency);
+        }
+    }
+
+    void steadyTone(double time) override {
+        if (audio) {
+            audio->steadyTone(time);
+        }
+    }
+
+    void silence(double time) override {
+        if (audio) {
+            audio->silence(time);
+        }
+    }
+
+    long long transitions = 0;
+    long long pulses = 0;
+
+private:
+    FILE* events;
+    WavRenderer* audio;
+};
+
+struct ReplayOptions {
+    AoaThresholds thresholds = defaultAoaThresholds();
+    int window = AOA_HISTORY_SIZE;
+    float spikeLimit = MAX_AOA_CHANGE;
+    ToneSettings tone = defaultToneSettings();
+    bool recordedSound = false;         // follow the recorded Sound button instead of assuming it was on
+    const char* eventsPath = nullptr;
+    const char* wavPath = nullptr;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void usage() {
+    fprintf(stderr,
+        "usage: tone_replay <recording.fosrec>... [options]\n"
+        "  --profile FILE         setpoints, filter window and tone settings from an aircraft profile,\n"
+        "                         options after it override its values\n"
+        "  --thresholds A,B,C,D   L/Dmax, OnSpeed low, OnSpeed high and stall warning AOA (default %g,%g,%g,%g)\n"
+        "  --ias-enable N         IAS below which there is no tone (default %g)\n"
+        "  --window N             moving average frames, 1 to %d (default %d)\n"
+        "  --spike-limit DEG      AOA change in one frame rejected as a spike (default %g)\n"
+        "  --recorded-sound       only play where the Sound button was on, rather than everywhere\n"
+        "  --events FILE          write zone transitions and pulses as CSV, - for stdout\n"
+        "  --wav FILE             render the audio, one recording only\n",
+        DEFAULT_AOA_BELOW_LDMAX, DEFAULT_AOA_BELOW_ONSPEED, DEFAULT_AOA_ONSPEED_MAX, DEFAULT_AOA_ABOVE_ONSPEED_MAX,
+        DEFAULT_AOA_IAS_TONE_ENABLE, AOA_HISTORY_MAX, AOA_HISTORY_SIZE, MAX_AOA_CHANGE);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool parseThresholds(const char* text, AoaThresholds& thresholds) {
+    float values[4];
+    if (sscanf(text, "%f,%f,%f,%f", &values[0], &values[1], &values[2], &values[3]) != 4 ||
+        !(values[0] < values[1] && values[1] < values[2] && values[2] < values[3])) {
+        return false;
+    }
+    thresholds.belowLDMax = values[0];
+    thresholds.belowOnSpeed = values[1];
+    thresholds.onSpeedMax = values[2];
+    thresholds.aboveOnSpeedMax = values[3];
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Replay one recording and print its summary. Returns the simulated seconds, or -1 if it couldn't be read.
+double replay(const char* path, const ReplayOptions& options, FILE* events, WavRenderer* audio,
+              long long& totalFrames) {
+    std::vector<FlightRecord> records;
+    if (!loadFlightRecording(path, records)) {
+        fprintf(stderr, "%s is not a flight recording\n", path);
+        return -1.0;
+    }
+
+    ReplayListener listener(events, audio);
+    TonePipeline pipeline(options.thresholds, options.tone, &listener, options.window, options.spikeLimit);
+    double zoneSeconds[ZONE_COUNT] = {};
+    double lastTime = 0.0;
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    for (const FlightRecord& record : records) {
+        bool sound = !options.recordedSound || (record.flags & FLIGHT_RECORD_AUDIO_ENABLED);
+        pipeline.frame(record.time, record.rawAoa, record.ias, sound);
+        zoneSeconds[static_cast<int>(pipeline.zone())] += record.time - lastTime;
+        lastTime = record.time;
+    }
+    pipeline.finish(lastTime);
+    if (audio) {
+        audio->advance(lastTime);
+    }
+
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    totalFrames += static_cast<long long>(records.size());
+
+    printf("%s\n", path);
+    printf("  frames: %zu  simulated: %.1f s  wall: %.2f ms  (%.0fx real time)\n", records.size(), lastTime, wallMs,
+           wallMs > 0.0 ? 1000.0 * lastTime / wallMs : 0.0);
+    printf("  zone transitions: %lld  pulses: %lld\n", listener.transitions, listener.pulses);
+    for (int i = 0; i < ZONE_COUNT; i++) {
+        if (zoneSeconds[i] > 0.0) {
+            printf("  %-14s %8.1f s  %5.1f%%\n", toneZoneName(static_cast<ToneZone>(i)), zoneSeconds[i],
+                   lastTime > 0.0 ? 100.0 * zoneSeconds[i] / lastTime : 0.0);
+        }
+    }
+    return lastTime;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    std::vector<const char*> paths;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--profile") && hasValue) {
+            AircraftProfile profile;
+            char error[256];
+            if (!loadAircraftProfile(argv[++i], profile, error, sizeof(error))) {
+                fprintf(stderr, "Can't load %s: %s\n", argv[i], error);
+                return 1;
+            }
+            options.thresholds = profile.thresholds;
+            options.window = profile.filterWindow;
+            options.tone = profile.tone;
+        } else if (!strcmp(argv[i], "--thresholds") && hasValue) {
+            if (!parseThresholds(argv[++i], options.thresholds)) {
+                usage();
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--ias-enable") && hasValue) {
+            options.thresholds.iasToneEnable = static_cast<float>(atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--window") && hasValue) {
+            options.window = atoi(argv[++i]);
+            if (options.window < 1 || options.window > AOA_HISTORY_MAX) {
+                usage();
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--spike-limit") && hasValue) {
+            options.spikeLimit = static_cast<float>(atof(argv[++i]));
+            if (!(options.spikeLimit > 0.0f)) {
+                usage();
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--recorded-sound")) {
+            options.recordedSound = true;
+        } else if (!strcmp(argv[i], "--events") && hasValue) {
+            options.eventsPath = argv[++i];
+        } else if (!strcmp(argv[i], "--wav") && hasValue) {
+            options.wavPath = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            usage();
+            return 1;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || (options.wavPath && paths.size() > 1)) {
+        usage();
+        return 1;
+    }
+
+    FILE* events = nullptr;
+    if (options.eventsPath) {
+        events = strcmp(options.eventsPath, "-") ? fopen(options.eventsPath, "w") : stdout;
+        if (!events) {
+            fprintf(stderr, "Can't write %s\n", options.eventsPath);
+            return 1;
+        }
+        fprintf(events, "time,event,from_zone,to_zone,frequency,pulse_rate,avg_aoa\n");
+    }
+
+    WavRenderer audio(options.tone);
+    if (options.wavPath && !audio.open(options.wavPath)) {
+        fprintf(stderr, "Can't write %s\n", options.wavPath);
+        return 1;
+    }
+
+    int status = 0;
+    double totalSeconds = 0.0;
+    long long totalFrames = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    for (const char* path : paths) {
+        double seconds = replay(path, options, events, options.wavPath ? &audio : nullptr, totalFrames);
+        if (seconds < 0.0) {
+            status = 1;
+        } else {
+            totalSeconds += seconds;
+        }
+    }
+
+    if (paths.size() > 1) {
+        double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+        printf("total: %zu recordings  frames: %lld  simulated: %.1f h  wall: %.1f ms\n", paths.size(), totalFrames,
+               totalSeconds / 3600.0, wallMs);
+    }
+
+    audio.close();
+    if (events && events != stdout) {
+        fclose(events);
+    }
+    return status;
+}
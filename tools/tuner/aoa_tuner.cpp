@@ -0,0 +1,407 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Searches AOA setpoints and the moving average length against a corpus of flight recordings and writes the best
+// set as an aircraft profile.
+//
+//   aoa_tuner Output/*.fosrec --random 5000 --out C172.profile --aircraft Cessna_172SP.acf
+//   aoa_tuner Output/*.fosrec --grid 6 --stall-aoa 16
+//   aoa_tuner Output/*.fosrec --profile C172.profile --out C172.profile
+//
+// Candidates are replayed with the tone settings and IAS gate of --profile, if given, and --out starts from that
+// profile, so retuning a profile in place only changes the setpoints and the filter window.
+// Every candidate is replayed through the plugin's tone pipeline over every recording, one (candidate,
+// recording) pair per task on a work-stealing pool. Scores are lower-is-better sums of:
+//   stall cue lead     how far the Stall zone's lead before each stall is from --lead seconds
+//   missed stalls      AOA (after the spike filter) passed --stall-aoa without the Stall cue sounding
+//   false warnings     the Stall cue sounded with no stall within FALSE_WARNING_SECONDS
+//   chatter            zone transitions per minute of flight
+//   OnSpeed time       minus the share of approach time (flaps half or more) spent in the OnSpeed zone
+
+#include "aircraft_profile.h"
+#include "aoa_engine.h"
+#include "flight_recorder.h"
+#include "tone_pipeline.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Score weights
+const double WEIGHT_LEAD = 1.0;             // per second of lead error, averaged over stalls
+const double WEIGHT_MISSED = 10.0;          // per missed stall
+const double WEIGHT_FALSE = 2.0;            // per false warning
+const double WEIGHT_CHATTER = 0.5;          // per transition per minute
+const double WEIGHT_ONSPEED = 5.0;          // times the OnSpeed share of approach time
+
+const double FALSE_WARNING_SECONDS = 10.0;  // a Stall cue not followed by a stall within this is false
+const float STALL_REARM_DEGREES = 1.0f;     // AOA has to drop this far below the stall AOA to count another
+const float APPROACH_FLAP_RATIO = 0.5f;     // flaps at or past this count as approach
+
+struct Range {
+    float low;
+    float high;
+};
+
+struct Candidate {
+    AoaThresholds thresholds;
+    int window;
+};
+
+// What one candidate did over one recording
+struct Outcome {
+    double flyingSeconds = 0.0;         // above the IAS gate
+    double approachSeconds = 0.0;
+    double approachOnSpeedSeconds = 0.0;
+    long long transitions = 0;
+    int stalls = 0;
+    int missed = 0;
+    int falseWarnings = 0;
+    double leadError = 0.0;             // summed over stalls
+
+    void add(const Outcome& other) {
+        flyingSeconds += other.flyingSeconds;
+        approachSeconds += other.approachSeconds;
+        approachOnSpeedSeconds += other.approachOnSpeedSeconds;
+        transitions += other.transitions;
+        stalls += other.stalls;
+        missed += other.missed;
+        falseWarnings += other.falseWarnings;
+        leadError += other.leadError;
+    }
+};
+
+struct Scored {
+    size_t candidate;
+    double score;
+    Outcome outcome;
+};
+
+struct TunerOptions {
+    Range ldMax = {4.0f, 8.0f};
+    Range onSpeedLow = {6.0f, 9.0f};
+    Range onSpeedHigh = {8.0f, 11.5f};
+    Range stallWarning = {10.0f, 15.0f};
+    Range window = {5.0f, 40.0f};
+    int grid = 0;                       // steps per dimension, 0 for random search
+    int random = 2000;
+    unsigned seed = 1;
+    int threads = 0;
+    float stallAoa = 15.0f;
+    double lead = 2.0;
+    float iasEnable = DEFAULT_AOA_IAS_TONE_ENABLE;
+    AircraftProfile profile = defaultAircraftProfile();     // tone settings to replay with, the base for --out
+    const char* outPath = nullptr;
+    const char* aircraft = nullptr;
+    int top = 10;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tracks when the Stall cue starts so each stall can be scored against it
+class StallCueListener : public TonePipelineListener {
+public:
+    void zoneChanged(double time, ToneZone from, ToneZone to, float avgAoa) override {
+        transitions++;
+        if (to == ToneZone::Stall) {
+            cueStart = time;
+            cuePending = true;
+        }
+    }
+
+    long long transitions = 0;
+    double cueStart = 0.0;
+    bool cuePending = false;        // cue started and no stall seen yet
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+Outcome evaluate(const Candidate& candidate, const std::vector<FlightRecord>& records, const TunerOptions& options) {
+    StallCueListener cue;
+    TonePipeline pipeline(candidate.thresholds, options.profile.tone, &cue, candidate.window);
+    Outcome outcome;
+    bool stallArmed = true;
+    double lastTime = 0.0;
+
+    for (const FlightRecord& record : records) {
+        double elapsed = record.time - lastTime;
+        lastTime = record.time;
+        pipeline.frame(record.time, record.rawAoa, record.ias, true);
+        ToneZone zone = pipeline.zone();
+        float aoa = pipeline.filter().lastSample();     // sensor spikes aren't stalls
+
+        if (zone != ToneZone::BelowIAS) {
+            outcome.flyingSeconds += elapsed;
+            if (record.flapRatio >= APPROACH_FLAP_RATIO) {
+                outcome.approachSeconds += elapsed;
+                if (zone == ToneZone::OnSpeed) {
+                    outcome.approachOnSpeedSeconds += elapsed;
+                }
+            }
+        }
+
+        if (cue.cuePending && record.time - cue.cueStart > FALSE_WARNING_SECONDS) {
+            outcome.falseWarnings++;
+            cue.cuePending = false;
+        }
+
+        if (stallArmed && aoa >= options.stallAoa && record.ias >= options.iasEnable) {
+            stallArmed = false;
+            outcome.stalls++;
+            if (zone == ToneZone::Stall) {
+                outcome.leadError += std::fabs(record.time - cue.cueStart - options.lead);
+                cue.cuePending = false;
+            } else {
+                outcome.missed++;
+                outcome.leadError += options.lead;
+            }
+        } else if (aoa < options.stallAoa - STALL_REARM_DEGREES) {
+            stallArmed = true;
+        }
+    }
+    if (cue.cuePending) {
+        outcome.falseWarnings++;
+    }
+    outcome.transitions = cue.transitions;
+    return outcome;
+}
+
+double score(const Outcome& outcome) {
+    double minutes = outcome.flyingSeconds / 60.0;
+    return (outcome.stalls ? WEIGHT_LEAD * outcome.leadError / outcome.stalls : 0.0) +
+           WEIGHT_MISSED * outcome.missed +
+           WEIGHT_FALSE * outcome.falseWarnings +
+           (minutes > 0.0 ? WEIGHT_CHATTER * outcome.transitions / minutes : 0.0) -
+           (outcome.approachSeconds > 0.0 ? WEIGHT_ONSPEED * outcome.approachOnSpeedSeconds / outcome.approachSeconds
+                                          : 0.0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool isOrdered(const AoaThresholds& t) {
+    return t.belowLDMax < t.belowOnSpeed && t.belowOnSpeed < t.onSpeedMax && t.onSpeedMax < t.aboveOnSpeedMax;
+}
+
+float step(const Range& range, int index, int steps) {
+    return steps > 1 ? range.low + (range.high - range.low) * index / (steps - 1) : range.low;
+}
+
+std::vector<Candidate> makeCandidates(const TunerOptions& options) {
+    std::vector<Candidate> candidates;
+    Candidate candidate;
+    candidate.thresholds.iasToneEnable = options.iasEnable;
+
+    if (options.grid > 0) {
+        int n = options.grid;
+        for (int a = 0; a < n; a++)
+        for (int b = 0; b < n; b++)
+        for (int c = 0; c < n; c++)
+        for (int d = 0; d < n; d++)
+        for (int w = 0; w < n; w++) {
+            candidate.thresholds.belowLDMax = step(options.ldMax, a, n);
+            candidate.thresholds.belowOnSpeed = step(options.onSpeedLow, b, n);
+            candidate.thresholds.onSpeedMax = step(options.onSpeedHigh, c, n);
+            candidate.thresholds.aboveOnSpeedMax = step(options.stallWarning, d, n);
+            candidate.window = static_cast<int>(std::lround(step(options.window, w, n)));
+            if (isOrdered(candidate.thresholds)) {
+                candidates.push_back(candidate);
+            }
+        }
+        return candidates;
+    }
+
+    std::mt19937 rng(options.seed);
+    auto pick = [&rng](const Range& range) {
+        return std::uniform_real_distribution<float>(range.low, range.high)(rng);
+    };
+    // Give up on drawing if the ranges barely allow an ordered set
+    for (int tries = 0; static_cast<int>(candidates.size()) < options.random && tries < options.random * 100; tries++) {
+        candidate.thresholds.belowLDMax = pick(options.ldMax);
+        candidate.thresholds.belowOnSpeed = pick(options.onSpeedLow);
+        candidate.thresholds.onSpeedMax = pick(options.onSpeedHigh);
+        candidate.thresholds.aboveOnSpeedMax = pick(options.stallWarning);
+        candidate.window = static_cast<int>(std::lround(pick(options.window)));
+        if (isOrdered(candidate.thresholds)) {
+            candidates.push_back(candidate);
+        }
+    }
+    return candidates;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void usage() {
+    fprintf(stderr,
+        "usage: aoa_tuner <recording.fosrec>... [options]\n"
+        "  --ldmax LO:HI          L/Dmax AOA range to search (default 4:8)\n"
+        "  --onspeed-low LO:HI    bottom of OnSpeed (default 6:9)\n"
+        "  --onspeed-high LO:HI   top of OnSpeed (default 8:11.5)\n"
+        "  --stall-warning LO:HI  start of the stall warning (default 10:15)\n"
+        "  --window LO:HI         moving average frames (default 5:40, at most %d)\n"
+        "  --grid N               N evenly spaced values per range, N^5 candidates\n"
+        "  --random N             N random candidates instead (default 2000)\n"
+        "  --seed N               random search seed (default 1)\n"
+        "  --stall-aoa DEG        critical AOA, reaching it counts as a stall (default 15)\n"
+        "  --lead S               wanted stall warning lead in seconds (default 2)\n"
+        "  --ias-enable N         IAS below which there is no tone (default %g, or the profile's)\n"
+        "  --profile FILE         replay with this aircraft profile's tone settings and IAS gate, and start --out\n"
+        "                         from it\n"
+        "  --threads N            worker threads (default one per core)\n"
+        "  --top N                candidates to list (default 10)\n"
+        "  --out FILE             write the best set as an aircraft profile\n"
+        "  --aircraft NAME        acf file name to put in the profile (default the --profile one)\n",
+        AOA_HISTORY_MAX, DEFAULT_AOA_IAS_TONE_ENABLE);
+}
+
+bool parseRange(const char* text, Range& range) {
+    return sscanf(text, "%f:%f", &range.low, &range.high) == 2 && range.low <= range.high;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv) {
+    TunerOptions options;
+    std::vector<const char*> paths;
+    bool iasEnableSet = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (!strcmp(argv[i], "--ldmax") && hasValue) {
+            ok = parseRange(argv[++i], options.ldMax);
+        } else if (!strcmp(argv[i], "--onspeed-low") && hasValue) {
+            ok = parseRange(argv[++i], options.onSpeedLow);
+        } else if (!strcmp(argv[i], "--onspeed-high") && hasValue) {
+            ok = parseRange(argv[++i], options.onSpeedHigh);
+        } else if (!strcmp(argv[i], "--stall-warning") && hasValue) {
+            ok = parseRange(argv[++i], options.stallWarning);
+        } else if (!strcmp(argv[i], "--window") && hasValue) {
+            ok = parseRange(argv[++i], options.window) && options.window.low >= 1.0f &&
+                 options.window.high <= AOA_HISTORY_MAX;
+        } else if (!strcmp(argv[i], "--grid") && hasValue) {
+            options.grid = atoi(argv[++i]);
+            ok = options.grid > 0;
+        } else if (!strcmp(argv[i], "--random") && hasValue) {
+            options.random = atoi(argv[++i]);
+            options.grid = 0;
+            ok = options.random > 0;
+        } else if (!strcmp(argv[i], "--seed") && hasValue) {
+            options.seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--stall-aoa") && hasValue) {
+            options.stallAoa = static_cast<float>(atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--lead") && hasValue) {
+            options.lead = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--ias-enable") && hasValue) {
+            options.iasEnable = static_cast<float>(atof(argv[++i]));
+            iasEnableSet = true;
+        } else if (!strcmp(argv[i], "--profile") && hasValue) {
+            char error[256];
+            if (!loadAircraftProfile(argv[++i], options.profile, error, sizeof(error))) {
+                fprintf(stderr, "Can't load %s: %s\n", argv[i], error);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--threads") && hasValue) {
+            options.threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--top") && hasValue) {
+            options.top = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--out") && hasValue) {
+            options.outPath = argv[++i];
+        } else if (!strcmp(argv[i], "--aircraft") && hasValue) {
+            options.aircraft = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            ok = false;
+        } else {
+            paths.push_back(argv[i]);
+        }
+        if (!ok) {
+            usage();
+            return 1;
+        }
+    }
+    if (paths.empty()) {
+        usage();
+        return 1;
+    }
+    if (!iasEnableSet) {
+        options.iasEnable = options.profile.thresholds.iasToneEnable;
+    }
+
+    std::vector<std::vector<FlightRecord>> corpus(paths.size());
+    double corpusSeconds = 0.0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!loadFlightRecording(paths[i], corpus[i])) {
+            fprintf(stderr, "%s is not a flight recording\n", paths[i]);
+            return 1;
+        }
+        if (!corpus[i].empty()) {
+            corpusSeconds += corpus[i].back().time;
+        }
+    }
+
+    std::vector<Candidate> candidates = makeCandidates(options);
+    if (candidates.empty()) {
+        fprintf(stderr, "No ordered threshold set fits the ranges\n");
+        return 1;
+    }
+
+    // One task per (candidate, recording), each writes only its own outcome
+    size_t recordings = corpus.size();
+    std::vector<Outcome> outcomes(candidates.size() * recordings);
+    WorkStealingPool pool(options.threads);
+    auto wallStart = std::chrono::steady_clock::now();
+
+    pool.run(outcomes.size(), [&](size_t index, int worker) {
+        outcomes[index] = evaluate(candidates[index / recordings], corpus[index % recordings], options);
+    });
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::vector<Scored> scored(candidates.size());
+    for (size_t c = 0; c < candidates.size(); c++) {
+        scored[c].candidate = c;
+        for (size_t r = 0; r < recordings; r++) {
+            scored[c].outcome.add(outcomes[c * recordings + r]);
+        }
+        scored[c].score = score(scored[c].outcome);
+    }
+    std::sort(scored.begin(), scored.end(), [](const Scored& a, const Scored& b) { return a.score < b.score; });
+
+    printf("%zu candidates x %zu recordings (%.1f h) on %d threads: %.2f s, %.0fx real time, %lld steals\n",
+           candidates.size(), recordings, corpusSeconds / 3600.0, pool.threads(), wallSeconds,
+           wallSeconds > 0.0 ? corpusSeconds * candidates.size() / wallSeconds : 0.0, pool.steals());
+    printf("%8s  %6s %6s %6s %6s %4s  %6s %6s %5s %7s %8s\n", "score", "ldmax", "on_lo", "on_hi", "stall", "win",
+           "stalls", "missed", "false", "trans", "onspeed");
+    for (int i = 0; i < options.top && i < static_cast<int>(scored.size()); i++) {
+        const Candidate& c = candidates[scored[i].candidate];
+        const Outcome& o = scored[i].outcome;
+        printf("%8.3f  %6.2f %6.2f %6.2f %6.2f %4d  %6d %6d %5d %7lld %7.1f%%\n", scored[i].score,
+               c.thresholds.belowLDMax, c.thresholds.belowOnSpeed, c.thresholds.onSpeedMax,
+               c.thresholds.aboveOnSpeedMax, c.window, o.stalls, o.missed, o.falseWarnings, o.transitions,
+               o.approachSeconds > 0.0 ? 100.0 * o.approachOnSpeedSeconds / o.approachSeconds : 0.0);
+    }
+
+    if (options.outPath) {
+        const Candidate& best = candidates[scored.front().candidate];
+        AircraftProfile profile = options.profile;
+        if (options.aircraft) {
+            snprintf(profile.aircraft, sizeof(profile.aircraft), "%s", options.aircraft);
+        }
+        profile.thresholds = best.thresholds;
+        profile.filterWindow = best.window;
+        if (!saveAircraftProfile(options.outPath, profile)) {
+            fprintf(stderr, "Can't write %s\n", options.outPath);
+            return 1;
+        }
+        printf("best set written to %s\n", options.outPath);
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "work_stealing_pool.h"
+
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+WorkStealingPool::WorkStealingPool(int threads)
+    : workerCount(threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency())),
+      stealCount(0) {
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+    slices.reset(new Slice[workerCount]);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkStealingPool::run(size_t count, const std::function<void(size_t, int)>& task) {
+    stealCount.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < workerCount; i++) {
+        slices[i].begin = count * i / workerCount;
+        slices[i].end = count * (i + 1) / workerCount;
+    }
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < workerCount; i++) {
+        workers.emplace_back(&WorkStealingPool::work, this, i, std::cref(task));
+    }
+    work(0, task);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkStealingPool::work(int worker, const std::function<void(size_t, int)>& task) {
+    Slice& own = slices[worker];
+    for (;;) {
+        size_t index = 0;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.begin < own.end) {
+                index = own.begin++;
+                found = true;
+            }
+        }
+        if (found) {
+            task(index, worker);
+            continue;
+        }
+        if (!steal(worker)) {
+            return;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Take the back half of the largest remaining slice. Returns false once there is nothing left anywhere.
+bool WorkStealingPool::steal(int thief) {
+    for (;;) {
+        int victim = -1;
+        size_t most = 0;
+        for (int i = 0; i < workerCount; i++) {
+            if (i == thief) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(slices[i].mutex);
+            size_t remaining = slices[i].end - slices[i].begin;
+            if (remaining > most) {
+                most = remaining;
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            return false;
+        }
+
+        size_t begin;
+        size_t end;
+        {
+            std::lock_guard<std::mutex> lock(slices[victim].mutex);
+            size_t remaining = slices[victim].end - slices[victim].begin;
+            if (remaining == 0) {
+                continue;       // finished while we looked, pick again
+            }
+            end = slices[victim].end;
+            begin = end - (remaining + 1) / 2;
+            slices[victim].end = begin;
+        }
+
+        std::lock_guard<std::mutex> lock(slices[thief].mutex);
+        slices[thief].begin = begin;
+        slices[thief].end = end;
+        stealCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
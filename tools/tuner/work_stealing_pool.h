@@ -0,0 +1,44 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Runs a batch of independent tasks 0..count-1 across worker threads.
+// Each worker starts with an equal contiguous slice and works through it from the front. A worker that runs out
+// steals the back half of the busiest worker's slice, so recordings of very different lengths still keep
+// every core busy to the end. Tasks are indices, there is no per-task allocation.
+class WorkStealingPool {
+public:
+    // threads <= 0 means one per hardware thread
+    explicit WorkStealingPool(int threads = 0);
+
+    int threads() const { return workerCount; }
+
+    // Call task(index, worker) once for every index and return when all are done
+    void run(size_t count, const std::function<void(size_t index, int worker)>& task);
+
+    // Slices taken from another worker during the last run
+    long long steals() const { return stealCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Slice {
+        std::mutex mutex;
+        size_t begin;
+        size_t end;
+    };
+
+    void work(int worker, const std::function<void(size_t, int)>& task);
+    bool steal(int thief);
+
+    int workerCount;
+    std::unique_ptr<Slice[]> slices;
+    std::atomic<long long> stealCount;
+};
+
+#endif // WORK_STEALING_POOL_H
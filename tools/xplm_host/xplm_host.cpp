@@ -0,0 +1,815 @@
+#include "xplm_host.h"
+
+#include "XPLMDataAccess.h"
+#include "XPLMDisplay.h"
+#include "XPLMGraphics.h"
+#include "XPLMMenus.h"
+#include "XPLMPlanes.h"
+#include "XPLMPlugin.h"
+#include "XPLMProcessing.h"
+#include "XPLMUtilities.h"
+#include "XPStandardWidgets.h"
+#include "XPWidgets.h"
+
+#include <dlfcn.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Host state
+
+namespace {
+
+// Room every widget descriptor gets up front, so a plugin changing a caption doesn't make the host allocate
+// where X-Plane wouldn't
+const size_t WIDGET_DESCRIPTOR_RESERVE = 256;
+
+struct HostDataRef {
+    std::string name;
+    XPLMDataTypeID types = xplmType_Unknown;
+
+    // Value set by the runner
+    double value = 0.0;
+    std::vector<float> floats;
+    std::vector<char> bytes;
+
+    // Accessors registered by the plugin
+    bool isAccessor = false;
+    XPLMGetDatai_f readInt = nullptr;
+    XPLMGetDataf_f readFloat = nullptr;
+    XPLMGetDatad_f readDouble = nullptr;
+    XPLMGetDatavf_f readFloatArray = nullptr;
+    XPLMGetDatab_f readData = nullptr;
+    void* readRefcon = nullptr;
+};
+
+struct HostFlightLoop {
+    XPLMFlightLoop_f callback;
+    void* refcon;
+    float interval;             // > 0 seconds, < 0 frames, 0 stopped
+    double lastCallTime;
+    long long lastCallFrame;
+};
+
+struct HostMenuItem {
+    std::string name;
+    void* itemRef;
+};
+
+struct HostMenu {
+    std::string name;
+    XPLMMenuHandler_f handler;
+    void* menuRef;
+    std::vector<HostMenuItem> items;
+};
+
+struct HostWidget {
+    int left, top, right, bottom;
+    bool visible;
+    bool isRoot;
+    std::string descriptor;
+    XPWidgetClass widgetClass;
+    HostWidget* parent;
+    std::vector<HostWidget*> children;
+    std::map<XPWidgetPropertyID, intptr_t> properties;
+    std::vector<XPWidgetFunc_t> callbacks;     // most recently added first
+};
+
+struct HostWindow {
+    int left, top, right, bottom;
+    bool visible;
+    std::string title;
+    XPLMDrawWindow_f draw;
+    void* refcon;
+};
+
+typedef int (*XPluginStart_f)(char*, char*, char*);
+typedef void (*XPluginStop_f)(void);
+typedef int (*XPluginEnable_f)(void);
+typedef void (*XPluginDisable_f)(void);
+typedef void (*XPluginReceiveMessage_f)(XPLMPluginID, int, void*);
+
+struct HostPlugin {
+    void* handle = nullptr;
+    XPluginStart_f start = nullptr;
+    XPluginStop_f stop = nullptr;
+    XPluginEnable_f enable = nullptr;
+    XPluginDisable_f disable = nullptr;
+    XPluginReceiveMessage_f receiveMessage = nullptr;
+    bool enabled = false;
+};
+
+std::map<std::string, std::unique_ptr<HostDataRef>> dataRefs;
+std::vector<std::unique_ptr<HostFlightLoop>> flightLoops;
+std::vector<std::unique_ptr<HostMenu>> menus;
+std::vector<std::unique_ptr<HostWidget>> widgets;
+std::vector<std::unique_ptr<HostWindow>> windows;
+HostMenu pluginsMenu = {"Plugins", nullptr, nullptr, {}};
+HostPlugin plugin;
+
+std::string systemPath = "./";
+std::string userAircraftPath = "Aircraft/Laminar Research/Cessna 172SP/Cessna_172SP.acf";
+bool logEnabled = true;
+bool reloadRequested = false;
+
+double simTime = 0.0;
+float lastFrameElapsed = 0.0f;
+XPHostStats stats = {0, 0, 0, 0, 0, 0};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+HostDataRef* findOrCreateDataRef(const char* name) {
+    std::unique_ptr<HostDataRef>& ref = dataRefs[name];
+    if (!ref) {
+        ref.reset(new HostDataRef());
+        ref->name = name;
+    }
+    return ref.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double readScalar(HostDataRef* ref) {
+    stats.dataRefReads++;
+    if (!ref->isAccessor) {
+        return ref->value;
+    }
+    if (ref->readDouble) return ref->readDouble(ref->readRefcon);
+    if (ref->readFloat) return ref->readFloat(ref->readRefcon);
+    if (ref->readInt) return ref->readInt(ref->readRefcon);
+    return 0.0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+HostWidget* findWidget(XPWidgetID id) {
+    for (auto& widget : widgets) {
+        if (widget.get() == id) {
+            return widget.get();
+        }
+    }
+    return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+HostWidget* findWidgetByPrefix(const char* prefix) {
+    for (auto& widget : widgets) {
+        if (widget->descriptor.compare(0, strlen(prefix), prefix) == 0) {
+            return widget.get();
+        }
+    }
+    return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Send a message to a widget and then up through its parents until someone handles it
+int sendUpChain(HostWidget* widget, XPWidgetMessage message, intptr_t param1, intptr_t param2) {
+    for (HostWidget* w = widget; w; w = w->parent) {
+        // Callbacks can add callbacks, so walk a copy
+        std::vector<XPWidgetFunc_t> callbacks = w->callbacks;
+        for (XPWidgetFunc_t callback : callbacks) {
+            if (callback(message, w, param1, param2)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void destroyWidget(HostWidget* widget, bool destroyChildren) {
+    // xpMsg_Destroy goes to the widget itself only
+    std::vector<XPWidgetFunc_t> callbacks = widget->callbacks;
+    for (XPWidgetFunc_t callback : callbacks) {
+        if (callback(xpMsg_Destroy, widget, destroyChildren, 0)) {
+            break;
+        }
+    }
+
+    std::vector<HostWidget*> children = widget->children;
+    for (HostWidget* child : children) {
+        if (destroyChildren) {
+            destroyWidget(child, true);
+        } else {
+            child->parent = nullptr;
+        }
+    }
+    if (widget->parent) {
+        std::vector<HostWidget*>& siblings = widget->parent->children;
+        for (size_t i = 0; i < siblings.size(); i++) {
+            if (siblings[i] == widget) {
+                siblings.erase(siblings.begin() + i);
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < widgets.size(); i++) {
+        if (widgets[i].get() == widget) {
+            widgets.erase(widgets.begin() + i);
+            break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void hostLog(const char* text) {
+    if (logEnabled) {
+        fputs(text, stdout);
+    }
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMUtilities
+
+void XPLMDebugString(const char* inString) {
+    hostLog(inString);
+}
+
+void XPLMGetSystemPath(char* outSystemPath) {
+    strcpy(outSystemPath, systemPath.c_str());
+}
+
+const char* XPLMGetDirectorySeparator(void) {
+    return "/";
+}
+
+void XPLMReloadPlugins(void) {
+    reloadRequested = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMPlanes
+
+void XPLMGetNthAircraftModel(int inIndex, char* outFileName, char* outPath) {
+    outFileName[0] = '\0';
+    outPath[0] = '\0';
+    if (inIndex != XPLM_USER_AIRCRAFT || userAircraftPath.empty()) {
+        return;
+    }
+    size_t slash = userAircraftPath.rfind('/');
+    std::string fileName = slash == std::string::npos ? userAircraftPath : userAircraftPath.substr(slash + 1);
+    snprintf(outFileName, 256, "%s", fileName.c_str());
+    snprintf(outPath, 512, "%s%s", systemPath.c_str(), userAircraftPath.c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMPlugin
+
+void XPLMEnableFeature(const char* inFeature, int inEnable) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMDataAccess
+
+XPLMDataRef XPLMFindDataRef(const char* inDataRefName) {
+    auto found = dataRefs.find(inDataRefName);
+    return found == dataRefs.end() ? nullptr : found->second.get();
+}
+
+XPLMDataTypeID XPLMGetDataRefTypes(XPLMDataRef inDataRef) {
+    return static_cast<HostDataRef*>(inDataRef)->types;
+}
+
+int XPLMGetDatai(XPLMDataRef inDataRef) {
+    return static_cast<int>(readScalar(static_cast<HostDataRef*>(inDataRef)));
+}
+
+float XPLMGetDataf(XPLMDataRef inDataRef) {
+    return static_cast<float>(readScalar(static_cast<HostDataRef*>(inDataRef)));
+}
+
+double XPLMGetDatad(XPLMDataRef inDataRef) {
+    return readScalar(static_cast<HostDataRef*>(inDataRef));
+}
+
+int XPLMGetDatavf(XPLMDataRef inDataRef, float* outValues, int inOffset, int inMax) {
+    HostDataRef* ref = static_cast<HostDataRef*>(inDataRef);
+    stats.dataRefReads++;
+    if (ref->isAccessor) {
+        return ref->readFloatArray ? ref->readFloatArray(ref->readRefcon, outValues, inOffset, inMax) : 0;
+    }
+    int size = static_cast<int>(ref->floats.size());
+    if (!outValues) {
+        return size;
+    }
+    int count = 0;
+    for (int i = inOffset; i < size && count < inMax; i++) {
+        outValues[count++] = ref->floats[i];
+    }
+    return count;
+}
+
+int XPLMGetDatab(XPLMDataRef inDataRef, void* outValue, int inOffset, int inMaxBytes) {
+    HostDataRef* ref = static_cast<HostDataRef*>(inDataRef);
+    stats.dataRefReads++;
+    if (ref->isAccessor) {
+        return ref->readData ? ref->readData(ref->readRefcon, outValue, inOffset, inMaxBytes) : 0;
+    }
+    int size = static_cast<int>(ref->bytes.size());
+    if (!outValue) {
+        return size;
+    }
+    int count = 0;
+    for (int i = inOffset; i < size && count < inMaxBytes; i++) {
+        static_cast<char*>(outValue)[count++] = ref->bytes[i];
+    }
+    return count;
+}
+
+XPLMDataRef XPLMRegisterDataAccessor(
+    const char* inDataName, XPLMDataTypeID inDataType, int inIsWritable,
+    XPLMGetDatai_f inReadInt, XPLMSetDatai_f inWriteInt,
+    XPLMGetDataf_f inReadFloat, XPLMSetDataf_f inWriteFloat,
+    XPLMGetDatad_f inReadDouble, XPLMSetDatad_f inWriteDouble,
+    XPLMGetDatavi_f inReadIntArray, XPLMSetDatavi_f inWriteIntArray,
+    XPLMGetDatavf_f inReadFloatArray, XPLMSetDatavf_f inWriteFloatArray,
+    XPLMGetDatab_f inReadData, XPLMSetDatab_f inWriteData,
+    void* inReadRefcon, void* inWriteRefcon) {
+    HostDataRef* ref = findOrCreateDataRef(inDataName);
+    ref->types = inDataType;
+    ref->isAccessor = true;
+    ref->readInt = inReadInt;
+    ref->readFloat = inReadFloat;
+    ref->readDouble = inReadDouble;
+    ref->readFloatArray = inReadFloatArray;
+    ref->readData = inReadData;
+    ref->readRefcon = inReadRefcon;
+    return ref;
+}
+
+void XPLMUnregisterDataAccessor(XPLMDataRef inDataRef) {
+    HostDataRef* ref = static_cast<HostDataRef*>(inDataRef);
+    dataRefs.erase(ref->name);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMProcessing
+
+void XPLMRegisterFlightLoopCallback(XPLMFlightLoop_f inFlightLoop, float inInterval, void* inRefcon) {
+    flightLoops.emplace_back(new HostFlightLoop{inFlightLoop, inRefcon, inInterval, simTime, stats.frames});
+}
+
+void XPLMUnregisterFlightLoopCallback(XPLMFlightLoop_f inFlightLoop, void* inRefcon) {
+    // Only mark it, XPHostRunFrame may be walking the list
+    for (auto& loop : flightLoops) {
+        if (loop->callback == inFlightLoop && loop->refcon == inRefcon) {
+            loop->callback = nullptr;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMMenus
+
+XPLMMenuID XPLMFindPluginsMenu(void) {
+    return &pluginsMenu;
+}
+
+XPLMMenuID XPLMCreateMenu(const char* inName, XPLMMenuID inParentMenu, int inParentItem,
+                          XPLMMenuHandler_f inHandler, void* inMenuRef) {
+    menus.emplace_back(new HostMenu{inName, inHandler, inMenuRef, {}});
+    return menus.back().get();
+}
+
+void XPLMDestroyMenu(XPLMMenuID inMenuID) {
+    for (size_t i = 0; i < menus.size(); i++) {
+        if (menus[i].get() == inMenuID) {
+            menus.erase(menus.begin() + i);
+            return;
+        }
+    }
+}
+
+int XPLMAppendMenuItem(XPLMMenuID inMenu, const char* inItemName, void* inItemRef, int inDeprecatedAndIgnored) {
+    HostMenu* menu = static_cast<HostMenu*>(inMenu);
+    menu->items.push_back(HostMenuItem{inItemName, inItemRef});
+    return static_cast<int>(menu->items.size()) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMDisplay. Windows are rectangles with a draw callback, called once a frame while visible.
+
+XPLMWindowID XPLMCreateWindowEx(XPLMCreateWindow_t* inParams) {
+    windows.emplace_back(new HostWindow{inParams->left, inParams->top, inParams->right, inParams->bottom,
+                                        inParams->visible != 0, std::string(), inParams->drawWindowFunc,
+                                        inParams->refcon});
+    return windows.back().get();
+}
+
+void XPLMDestroyWindow(XPLMWindowID inWindowID) {
+    for (size_t i = 0; i < windows.size(); i++) {
+        if (windows[i].get() == inWindowID) {
+            windows.erase(windows.begin() + i);
+            return;
+        }
+    }
+}
+
+void XPLMGetWindowGeometry(XPLMWindowID inWindowID, int* outLeft, int* outTop, int* outRight, int* outBottom) {
+    HostWindow* window = static_cast<HostWindow*>(inWindowID);
+    if (outLeft) *outLeft = window->left;
+    if (outTop) *outTop = window->top;
+    if (outRight) *outRight = window->right;
+    if (outBottom) *outBottom = window->bottom;
+}
+
+void XPLMSetWindowGeometry(XPLMWindowID inWindowID, int inLeft, int inTop, int inRight, int inBottom) {
+    HostWindow* window = static_cast<HostWindow*>(inWindowID);
+    window->left = inLeft;
+    window->top = inTop;
+    window->right = inRight;
+    window->bottom = inBottom;
+}
+
+int XPLMGetWindowIsVisible(XPLMWindowID inWindowID) {
+    return static_cast<HostWindow*>(inWindowID)->visible ? 1 : 0;
+}
+
+void XPLMSetWindowIsVisible(XPLMWindowID inWindowID, int inIsVisible) {
+    static_cast<HostWindow*>(inWindowID)->visible = inIsVisible != 0;
+}
+
+void XPLMSetWindowTitle(XPLMWindowID inWindowID, const char* inWindowTitle) {
+    static_cast<HostWindow*>(inWindowID)->title = inWindowTitle;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPLMGraphics. There is no GL context; state changes are ignored and strings only counted.
+
+void XPLMSetGraphicsState(int inEnableFog, int inNumberTexUnits, int inEnableLighting, int inEnableAlphaTesting,
+                          int inEnableAlphaBlending, int inEnableDepthTesting, int inEnableDepthWriting) {
+}
+
+void XPLMDrawString(float* inColorRGB, int inXOffset, int inYOffset, const char* inChar, int* inWordWrapWidth,
+                    XPLMFontID inFontID) {
+    stats.stringDraws++;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XPWidgets
+
+XPWidgetID XPCreateWidget(int inLeft, int inTop, int inRight, int inBottom, int inVisible,
+                          const char* inDescriptor, int inIsRoot, XPWidgetID inContainer, XPWidgetClass inClass) {
+    HostWidget* parent = findWidget(inContainer);
+    widgets.emplace_back(new HostWidget{inLeft, inTop, inRight, inBottom, inVisible != 0, inIsRoot != 0,
+                                        inDescriptor ? inDescriptor : "", inClass, parent, {}, {}, {}});
+    HostWidget* widget = widgets.back().get();
+    widget->descriptor.reserve(WIDGET_DESCRIPTOR_RESERVE);
+    if (parent) {
+        parent->children.push_back(widget);
+    }
+    return widget;
+}
+
+void XPDestroyWidget(XPWidgetID inWidget, int inDestroyChildren) {
+    if (HostWidget* widget = findWidget(inWidget)) {
+        destroyWidget(widget, inDestroyChildren != 0);
+    }
+}
+
+void XPShowWidget(XPWidgetID inWidget) {
+    if (HostWidget* widget = findWidget(inWidget)) widget->visible = true;
+}
+
+void XPHideWidget(XPWidgetID inWidget) {
+    if (HostWidget* widget = findWidget(inWidget)) widget->visible = false;
+}
+
+int XPIsWidgetVisible(XPWidgetID inWidget) {
+    HostWidget* widget = findWidget(inWidget);
+    return widget && widget->visible;
+}
+
+void XPGetWidgetGeometry(XPWidgetID inWidget, int* outLeft, int* outTop, int* outRight, int* outBottom) {
+    HostWidget* widget = findWidget(inWidget);
+    if (!widget) return;
+    if (outLeft) *outLeft = widget->left;
+    if (outTop) *outTop = widget->top;
+    if (outRight) *outRight = widget->right;
+    if (outBottom) *outBottom = widget->bottom;
+}
+
+void XPSetWidgetGeometry(XPWidgetID inWidget, int inLeft, int inTop, int inRight, int inBottom) {
+    HostWidget* widget = findWidget(inWidget);
+    if (!widget) return;
+    widget->left = inLeft;
+    widget->top = inTop;
+    widget->right = inRight;
+    widget->bottom = inBottom;
+}
+
+void XPSetWidgetDescriptor(XPWidgetID inWidget, const char* inDescriptor) {
+    stats.widgetDescriptorSets++;
+    if (HostWidget* widget = findWidget(inWidget)) widget->descriptor = inDescriptor;
+}
+
+int XPGetWidgetDescriptor(XPWidgetID inWidget, char* outDescriptor, int inMaxDescLength) {
+    HostWidget* widget = findWidget(inWidget);
+    if (!widget) return 0;
+    int length = static_cast<int>(widget->descriptor.size());
+    if (outDescriptor && inMaxDescLength > 0) {
+        snprintf(outDescriptor, inMaxDescLength, "%s", widget->descriptor.c_str());
+    }
+    return length;
+}
+
+void XPSetWidgetProperty(XPWidgetID inWidget, XPWidgetPropertyID inProperty, intptr_t inValue) {
+    if (HostWidget* widget = findWidget(inWidget)) widget->properties[inProperty] = inValue;
+}
+
+intptr_t XPGetWidgetProperty(XPWidgetID inWidget, XPWidgetPropertyID inProperty, int* inExists) {
+    HostWidget* widget = findWidget(inWidget);
+    auto found = widget ? widget->properties.find(inProperty) : std::map<XPWidgetPropertyID, intptr_t>::iterator();
+    bool exists = widget && found != widget->properties.end();
+    if (inExists) *inExists = exists;
+    return exists ? found->second : 0;
+}
+
+void XPAddWidgetCallback(XPWidgetID inWidget, XPWidgetFunc_t inNewCallback) {
+    if (HostWidget* widget = findWidget(inWidget)) {
+        widget->callbacks.insert(widget->callbacks.begin(), inNewCallback);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Host control API
+
+void XPHostSetDataf(const char* name, float value) {
+    HostDataRef* ref = findOrCreateDataRef(name);
+    ref->types = xplmType_Float | xplmType_Double;
+    ref->value = value;
+}
+
+void XPHostSetDatai(const char* name, int value) {
+    HostDataRef* ref = findOrCreateDataRef(name);
+    ref->types = xplmType_Int;
+    ref->value = value;
+}
+
+void XPHostSetDatavf(const char* name, const float* values, int count) {
+    HostDataRef* ref = findOrCreateDataRef(name);
+    ref->types = xplmType_FloatArray;
+    ref->floats.assign(values, values + count);
+}
+
+void XPHostSetDatab(const char* name, const void* data, int size) {
+    HostDataRef* ref = findOrCreateDataRef(name);
+    ref->types = xplmType_Data;
+    ref->bytes.assign(static_cast<const char*>(data), static_cast<const char*>(data) + size);
+}
+
+float XPHostGetDataf(const char* name) {
+    XPLMDataRef ref = XPLMFindDataRef(name);
+    return ref ? XPLMGetDataf(ref) : 0.0f;
+}
+
+int XPHostGetDatai(const char* name) {
+    XPLMDataRef ref = XPLMFindDataRef(name);
+    return ref ? XPLMGetDatai(ref) : 0;
+}
+
+bool XPHostHasDataRef(const char* name) {
+    return XPLMFindDataRef(name) != nullptr;
+}
+
+void XPHostSetSystemPath(const char* path) {
+    systemPath = path;
+}
+
+void XPHostLoadUserAircraft(const char* path) {
+    userAircraftPath = path;
+    XPHostSendMessage(XPLM_MSG_PLANE_LOADED, reinterpret_cast<void*>(static_cast<intptr_t>(XPLM_USER_AIRCRAFT)));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool XPHostLoadPlugin(const char* path) {
+    char msg[1024];
+
+    plugin = HostPlugin();
+    plugin.handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!plugin.handle) {
+        snprintf(msg, sizeof(msg), "host: dlopen failed: %s\n", dlerror());
+        hostLog(msg);
+        return false;
+    }
+
+    plugin.start = reinterpret_cast<XPluginStart_f>(dlsym(plugin.handle, "XPluginStart"));
+    plugin.stop = reinterpret_cast<XPluginStop_f>(dlsym(plugin.handle, "XPluginStop"));
+    plugin.enable = reinterpret_cast<XPluginEnable_f>(dlsym(plugin.handle, "XPluginEnable"));
+    plugin.disable = reinterpret_cast<XPluginDisable_f>(dlsym(plugin.handle, "XPluginDisable"));
+    plugin.receiveMessage = reinterpret_cast<XPluginReceiveMessage_f>(dlsym(plugin.handle, "XPluginReceiveMessage"));
+    if (!plugin.start || !plugin.stop || !plugin.enable || !plugin.disable || !plugin.receiveMessage) {
+        hostLog("host: plugin is missing one of the five XPlugin entry points\n");
+        dlclose(plugin.handle);
+        plugin = HostPlugin();
+        return false;
+    }
+
+    char name[256] = "", signature[256] = "", description[256] = "";
+    if (!plugin.start(name, signature, description)) {
+        hostLog("host: XPluginStart failed\n");
+        dlclose(plugin.handle);
+        plugin = HostPlugin();
+        return false;
+    }
+    snprintf(msg, sizeof(msg), "host: started %s (%s)\n", name, signature);
+    hostLog(msg);
+
+    plugin.enabled = plugin.enable() != 0;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void XPHostUnloadPlugin() {
+    if (!plugin.handle) {
+        return;
+    }
+    if (plugin.enabled) {
+        plugin.disable();
+    }
+    plugin.stop();
+
+    // Report anything the plugin forgot, then drop it like X-Plane does since its code is about to go away
+    int loops = 0;
+    for (auto& loop : flightLoops) {
+        if (loop->callback) loops++;
+    }
+    int accessors = 0;
+    for (auto& ref : dataRefs) {
+        if (ref.second->isAccessor) accessors++;
+    }
+    if (loops || accessors || !widgets.empty() || !windows.empty() || !menus.empty()) {
+        char msg[256];
+        snprintf(msg, sizeof(msg),
+                 "host: plugin left %d flight loops, %d datarefs, %d widgets, %d windows, %d menus behind\n",
+                 loops, accessors, static_cast<int>(widgets.size()), static_cast<int>(windows.size()),
+                 static_cast<int>(menus.size()));
+        hostLog(msg);
+    }
+    flightLoops.clear();
+    widgets.clear();
+    windows.clear();
+    menus.clear();
+    pluginsMenu.items.clear();
+    for (auto it = dataRefs.begin(); it != dataRefs.end();) {
+        it = it->second->isAccessor ? dataRefs.erase(it) : std::next(it);
+    }
+
+    dlclose(plugin.handle);
+    plugin = HostPlugin();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void XPHostRunFrame(float elapsed) {
+    simTime += elapsed;
+    lastFrameElapsed = elapsed;
+    stats.frames++;
+
+    // Loops registered during this frame wait for the next one
+    size_t count = flightLoops.size();
+    for (size_t i = 0; i < count; i++) {
+        HostFlightLoop* loop = flightLoops[i].get();
+        if (!loop->callback || loop->interval == 0.0f) {
+            continue;
+        }
+
+        bool due = loop->interval > 0.0f
+            ? simTime - loop->lastCallTime >= loop->interval
+            : stats.frames - loop->lastCallFrame >= static_cast<long long>(-loop->interval);
+        if (!due) {
+            continue;
+        }
+
+        float sinceLastCall = static_cast<float>(simTime - loop->lastCallTime);
+        loop->lastCallTime = simTime;
+        loop->lastCallFrame = stats.frames;
+        stats.flightLoopCalls++;
+        float next = loop->callback(sinceLastCall, elapsed, static_cast<int>(stats.frames), loop->refcon);
+
+        // The callback may have unregistered itself
+        if (flightLoops[i]->callback) {
+            flightLoops[i]->interval = next;
+        }
+    }
+
+    for (size_t i = 0; i < flightLoops.size();) {
+        if (!flightLoops[i]->callback) {
+            flightLoops.erase(flightLoops.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    // Then the windows, like X-Plane draws after the flight model. A draw callback may not destroy windows.
+    for (auto& window : windows) {
+        if (window->visible && window->draw) {
+            stats.windowDraws++;
+            window->draw(window.get(), window->refcon);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void XPHostSendMessage(int message, void* param) {
+    if (plugin.receiveMessage) {
+        plugin.receiveMessage(XPLM_PLUGIN_XPLANE, message, param);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool XPHostPickMenuItem(const char* menuName, const char* itemName) {
+    for (auto& menu : menus) {
+        if (menu->name != menuName || !menu->handler) {
+            continue;
+        }
+        for (HostMenuItem& item : menu->items) {
+            if (item.name == itemName) {
+                menu->handler(menu->menuRef, item.itemRef);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool XPHostPressButton(const char* descriptorPrefix) {
+    HostWidget* button = findWidgetByPrefix(descriptorPrefix);
+    if (!button || button->widgetClass != xpWidgetClass_Button || !button->visible) {
+        return false;
+    }
+    sendUpChain(button, xpMsg_PushButtonPressed, reinterpret_cast<intptr_t>(button), 0);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The field is the nearest text field to the right of the caption on the same row, as a labeled field is laid out
+bool XPHostTypeInField(const char* labelPrefix, const char* text) {
+    HostWidget* label = findWidgetByPrefix(labelPrefix);
+    if (!label) {
+        return false;
+    }
+    HostWidget* field = nullptr;
+    for (auto& widget : widgets) {
+        if (widget->widgetClass == xpWidgetClass_TextField && widget->parent == label->parent &&
+            widget->top == label->top && widget->left >= label->right &&
+            (!field || widget->left < field->left)) {
+            field = widget.get();
+        }
+    }
+    if (!field || !field->visible) {
+        return false;
+    }
+    field->descriptor = text;
+    sendUpChain(field, xpMsg_TextFieldChanged, reinterpret_cast<intptr_t>(field), 0);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::string XPHostFindWidgetText(const char* descriptorPrefix) {
+    HostWidget* widget = findWidgetByPrefix(descriptorPrefix);
+    return widget ? widget->descriptor : std::string();
+}
+
+XPHostStats XPHostGetStats() {
+    return stats;
+}
+
+bool XPHostTakeReloadRequest() {
+    bool requested = reloadRequested;
+    reloadRequested = false;
+    return requested;
+}
+
+void XPHostSetLogEnabled(bool enabled) {
+    logEnabled = enabled;
+}
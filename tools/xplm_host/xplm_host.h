@@ -0,0 +1,76 @@
+#ifndef XPLM_HOST_H
+#define XPLM_HOST_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Headless stand-in for X-Plane.
+// libXPLMHost implements the XPLM and XPWidgets entry points the plugin uses, so the .xpl can be loaded
+// with dlopen and driven off the sim box. Datarefs hold whatever the runner scripts into them, flight loops
+// are ticked with a simulated frame time, widgets are plain objects with no drawing. XPLM windows get their
+// draw callback once a frame while visible, with no GL context current.
+// The functions below are the host's own control API for the runner.
+
+#include <string>
+
+// Datarefs the sim would publish. Creates the dataref the first time it is set.
+void XPHostSetDataf(const char* name, float value);
+void XPHostSetDatai(const char* name, int value);
+void XPHostSetDatavf(const char* name, const float* values, int count);
+void XPHostSetDatab(const char* name, const void* data, int size);
+
+// Read any dataref by name, including ones a plugin registered. Returns 0 if it doesn't exist.
+float XPHostGetDataf(const char* name);
+int XPHostGetDatai(const char* name);
+bool XPHostHasDataRef(const char* name);
+
+// Path returned by XPLMGetSystemPath, should end with a separator
+void XPHostSetSystemPath(const char* path);
+
+// Switch the user aircraft, an .acf path relative to the system path, and send XPLM_MSG_PLANE_LOADED if a
+// plugin is loaded. Defaults to the Cessna 172SP.
+void XPHostLoadUserAircraft(const char* path);
+
+// Load the plugin and call XPluginStart and XPluginEnable
+bool XPHostLoadPlugin(const char* path);
+
+// Call XPluginDisable and XPluginStop and unload the plugin
+void XPHostUnloadPlugin();
+
+// Run one sim frame of elapsed seconds: every flight loop that is due gets called, then every visible window
+// is drawn
+void XPHostRunFrame(float elapsed);
+
+// Deliver an XPLM message to the plugin
+void XPHostSendMessage(int message, void* param);
+
+// Pick an item from one of the plugin's menus, by menu and item name
+bool XPHostPickMenuItem(const char* menuName, const char* itemName);
+
+// Press the button whose descriptor starts with prefix. Returns false if there is no such visible button.
+bool XPHostPressButton(const char* descriptorPrefix);
+
+// Replace the text of the field labeled by the caption whose descriptor starts with labelPrefix, as if typed.
+// Returns false if there is no such visible field.
+bool XPHostTypeInField(const char* labelPrefix, const char* text);
+
+// Descriptor of the first widget whose descriptor starts with prefix, empty if there isn't one
+std::string XPHostFindWidgetText(const char* descriptorPrefix);
+
+// Counters for how much the plugin talked to the host
+struct XPHostStats {
+    long long frames;
+    long long flightLoopCalls;
+    long long dataRefReads;
+    long long widgetDescriptorSets;
+    long long windowDraws;
+    long long stringDraws;
+};
+XPHostStats XPHostGetStats();
+
+// Whether the plugin called XPLMReloadPlugins since the last call; clears the flag
+bool XPHostTakeReloadRequest();
+
+// Send XPLMDebugString output to stdout (the default) or drop it
+void XPHostSetLogEnabled(bool enabled);
+
+#endif // XPLM_HOST_H
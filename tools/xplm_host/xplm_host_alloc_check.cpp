@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Loads a plugin into the headless host, flies it through a synthetic stall with the control window, tape and
+// scope open, and fails if the sim thread allocates once the plugin has settled.
+//
+//   xplm_host_alloc_check AOA-Tone-FlyOnSpeed.xpl --warmup 1 --seconds 3 --realtime
+//
+// The bench counts allocations in copies of the per-frame code; this counts them in the real flight loop,
+// dataref reads, widget captions and window draws included. Allocations are counted by replacing the global
+// operator new (alloc_counter.h), which the plugin's libstdc++ binds to, on the thread that runs the frames only: the store,
+// renderer and log threads allocate when they have work, which is the point of having them. Exits 2 if the
+// sim thread allocated during the measured frames.
+
+#include "alloc_counter.h"
+#include "xplm_host.h"
+#include "flight_profile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Datarefs the plugin needs before XPluginStart succeeds, the profile keeps the first four moving
+const char* SIM_DATAREFS[] = {
+    FLIGHT_PROFILE_AOA_DATAREF,
+    FLIGHT_PROFILE_IAS_DATAREF,
+    FLIGHT_PROFILE_G_DATAREF,
+    FLIGHT_PROFILE_FLAP_DATAREF,
+    "sim/cockpit2/gauges/indicators/AoA_pilot",
+    "sim/cockpit2/gauges/indicators/aoa_angle_degrees",
+};
+
+// Everything a pilot could have open while flying
+const char* MENU_PICKS[][2] = {
+    {"Fly On Speed", "Show"},
+    {"Fly On Speed", "Toggle AOA Tape"},
+    {"Fly On Speed", "Toggle AOA Scope"},
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void usage() {
+    fprintf(stderr,
+        "usage: xplm_host_alloc_check <plugin.xpl> [options]\n"
+        "  --fps N              simulated frame rate (default 60)\n"
+        "  --warmup S           simulated seconds before counting starts (default 1)\n"
+        "  --seconds S          simulated seconds counted (default 3)\n"
+        "  --root DIR           X-Plane folder returned by XPLMGetSystemPath\n"
+        "  --realtime           sleep so frames run at wall clock rate\n");
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    const char* pluginPath = argv[1];
+    float fps = 60.0f;
+    double warmup = 1.0;
+    double seconds = 3.0;
+    bool realtime = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--fps" && hasValue) {
+            fps = static_cast<float>(atof(argv[++i]));
+        } else if (arg == "--warmup" && hasValue) {
+            warmup = atof(argv[++i]);
+        } else if (arg == "--seconds" && hasValue) {
+            seconds = atof(argv[++i]);
+        } else if (arg == "--root" && hasValue) {
+            XPHostSetSystemPath(argv[++i]);
+        } else if (arg == "--realtime") {
+            realtime = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (fps <= 0.0f || seconds <= 0.0) {
+        usage();
+        return 1;
+    }
+
+    for (const char* name : SIM_DATAREFS) {
+        XPHostSetDataf(name, 0.0f);
+    }
+    if (!XPHostLoadPlugin(pluginPath)) {
+        return 1;
+    }
+    for (const auto& pick : MENU_PICKS) {
+        if (!XPHostPickMenuItem(pick[0], pick[1])) {
+            fprintf(stderr, "No menu item %s/%s\n", pick[0], pick[1]);
+            XPHostUnloadPlugin();
+            return 1;
+        }
+    }
+    XPHostPressButton("Sound: Off");     // unless a warm state left it on
+
+    // Stall passes repeated: every zone, zone changes both ways and the pulse rate sweeping
+    FlightProfileOptions options;
+    options.maneuver = FlightManeuver::PowerOffStall;
+    options.fps = fps;
+    options.seconds = warmup + seconds;
+    FlightProfile profile(options);
+
+    long long warmupFrames = static_cast<long long>(warmup * fps);
+    long long measuredFrames = 0;
+    double simTime = 0.0;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    FlightSample sample;
+    for (long long frame = 1; profile.next(sample); frame++) {
+        XPHostSetDataf(FLIGHT_PROFILE_AOA_DATAREF, sample.aoa);
+        XPHostSetDataf(FLIGHT_PROFILE_IAS_DATAREF, sample.ias);
+        XPHostSetDataf(FLIGHT_PROFILE_G_DATAREF, sample.gLoad);
+        XPHostSetDataf(FLIGHT_PROFILE_FLAP_DATAREF, sample.flapRatio);
+        simTime += sample.elapsed;
+
+        setCountAllocations(frame > warmupFrames);
+        XPHostRunFrame(sample.elapsed);
+        setCountAllocations(false);
+        measuredFrames += frame > warmupFrames ? 1 : 0;
+
+        if (realtime) {
+            std::this_thread::sleep_until(wallStart + std::chrono::duration<double>(simTime));
+        }
+    }
+
+    XPHostUnloadPlugin();
+
+    long long allocations = allocationCount();
+    XPHostStats stats = XPHostGetStats();
+    printf("frames: %lld  measured: %lld  sim thread allocations: %lld  window draws: %lld\n", stats.frames,
+           measuredFrames, allocations, stats.windowDraws);
+    if (measuredFrames == 0 || stats.windowDraws == 0) {
+        fprintf(stderr, "Nothing was measured\n");
+        return 1;
+    }
+    if (allocations > 0) {
+        fprintf(stderr, "The flight loop allocated %lld times in %lld steady state frames\n", allocations,
+                measuredFrames);
+        return 2;
+    }
+    return 0;
+}
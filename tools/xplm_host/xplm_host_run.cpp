@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Loads a plugin into the headless host and ticks it at a scripted frame rate with scripted dataref values.
+//
+//   xplm_host_run AOA-Tone-FlyOnSpeed.xpl --seconds 60 --fps 60 --script approach.csv --menu "Fly On Speed/Show"
+//
+// A script is a CSV file whose header is "time" followed by dataref names. Values are linearly interpolated
+// between rows and held after the last one. Instead of a script, --profile streams a synthetic flight from
+// the flight profile generator, frame time jitter included.
+
+#include "xplm_host.h"
+#include "flight_profile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Datarefs every X-Plane aircraft has, so a plugin can start without a script
+const char* SIM_DATAREFS[] = {
+    "sim/flightmodel/position/alpha",
+    "sim/flightmodel/position/indicated_airspeed",
+    "sim/cockpit2/gauges/indicators/AoA_pilot",
+    "sim/cockpit2/gauges/indicators/aoa_angle_degrees",
+    "sim/flightmodel/forces/g_nrml",
+    "sim/cockpit2/controls/flap_ratio",
+};
+
+struct Script {
+    std::vector<std::string> names;
+    std::vector<std::vector<double>> rows;      // time first, then one value per name
+    size_t row = 0;
+};
+
+struct AircraftSwitch {
+    double time;
+    std::string path;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> splitCsv(const char* line) {
+    std::vector<std::string> fields;
+    std::string field;
+    for (const char* c = line; *c && *c != '\n' && *c != '\r'; c++) {
+        if (*c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else {
+            field += *c;
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool loadScript(const char* path, Script& script) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Can't open script %s\n", path);
+        return false;
+    }
+
+    char line[4096];
+    if (!fgets(line, sizeof(line), file)) {
+        fclose(file);
+        return false;
+    }
+    std::vector<std::string> header = splitCsv(line);
+    script.names.assign(header.begin() + 1, header.end());
+
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        std::vector<std::string> fields = splitCsv(line);
+        std::vector<double> row;
+        for (const std::string& field : fields) {
+            row.push_back(atof(field.c_str()));
+        }
+        row.resize(header.size(), 0.0);
+        script.rows.push_back(row);
+    }
+
+    fclose(file);
+    return !script.rows.empty();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void applyScript(Script& script, double time) {
+    if (script.rows.empty()) {
+        return;
+    }
+    while (script.row + 1 < script.rows.size() && script.rows[script.row + 1][0] <= time) {
+        script.row++;
+    }
+
+    const std::vector<double>& a = script.rows[script.row];
+    const std::vector<double>& b = script.row + 1 < script.rows.size() ? script.rows[script.row + 1] : a;
+    double span = b[0] - a[0];
+    double t = span > 0.0 ? (time - a[0]) / span : 0.0;
+    if (t < 0.0) t = 0.0;
+    if (t > 1.0) t = 1.0;
+
+    for (size_t i = 0; i < script.names.size(); i++) {
+        XPHostSetDataf(script.names[i].c_str(), static_cast<float>(a[i + 1] + t * (b[i + 1] - a[i + 1])));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void usage() {
+    fprintf(stderr,
+        "usage: xplm_host_run <plugin.xpl> [options]\n"
+        "  --fps N              simulated frame rate (default 60)\n"
+        "  --seconds S          simulated time to run (default 10)\n"
+        "  --script FILE        CSV of dataref values over time\n"
+        "  --set NAME=VALUE     hold a dataref at a value\n"
+        "  --profile NAME       stream a synthetic flight: approach, stall, turns, turbulence or spikes\n"
+        "  --jitter F           with --profile, frame time varies by up to this fraction\n"
+        "  --seed N             with --profile, random seed\n"
+        "  --menu MENU/ITEM     pick a plugin menu item after start, e.g. \"Fly On Speed/Show\"\n"
+        "  --type LABEL=TEXT    type TEXT in the field labeled LABEL after start, before any --press\n"
+        "  --press PREFIX       press the button whose label starts with PREFIX after start\n"
+        "  --print NAME         print a dataref's value at the end\n"
+        "  --root DIR           X-Plane folder returned by XPLMGetSystemPath\n"
+        "  --aircraft ACF       user aircraft .acf path, relative to the X-Plane folder\n"
+        "  --switch-aircraft S:ACF  load another user aircraft S seconds in\n"
+        "  --realtime           sleep so frames run at wall clock rate\n"
+        "  --quiet              drop XPLMDebugString output\n");
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    const char* pluginPath = argv[1];
+    float fps = 60.0f;
+    double seconds = 10.0;
+    bool realtime = false;
+    bool useProfile = false;
+    FlightProfileOptions profileOptions;
+    Script script;
+    std::vector<std::string> menuPicks;
+    std::vector<std::string> typings;
+    std::vector<std::string> presses;
+    std::vector<std::string> prints;
+    std::vector<AircraftSwitch> aircraftSwitches;     // in the order given, times should increase
+    size_t nextSwitch = 0;
+
+    for (const char* name : SIM_DATAREFS) {
+        XPHostSetDataf(name, 0.0f);
+    }
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--fps" && hasValue) {
+            fps = static_cast<float>(atof(argv[++i]));
+        } else if (arg == "--seconds" && hasValue) {
+            seconds = atof(argv[++i]);
+        } else if (arg == "--script" && hasValue) {
+            if (!loadScript(argv[++i], script)) return 1;
+        } else if (arg == "--set" && hasValue) {
+            std::string set = argv[++i];
+            size_t eq = set.find('=');
+            if (eq == std::string::npos) {
+                usage();
+                return 1;
+            }
+            XPHostSetDataf(set.substr(0, eq).c_str(), static_cast<float>(atof(set.c_str() + eq + 1)));
+        } else if (arg == "--profile" && hasValue) {
+            if (!FlightProfile::parseManeuver(argv[++i], profileOptions.maneuver)) {
+                usage();
+                return 1;
+            }
+            useProfile = true;
+        } else if (arg == "--jitter" && hasValue) {
+            profileOptions.jitter = static_cast<float>(atof(argv[++i]));
+        } else if (arg == "--seed" && hasValue) {
+            profileOptions.seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--menu" && hasValue) {
+            menuPicks.push_back(argv[++i]);
+        } else if (arg == "--type" && hasValue) {
+            std::string typing = argv[++i];
+            if (typing.find('=') == std::string::npos) {
+                usage();
+                return 1;
+            }
+            typings.push_back(typing);
+        } else if (arg == "--press" && hasValue) {
+            presses.push_back(argv[++i]);
+        } else if (arg == "--print" && hasValue) {
+            prints.push_back(argv[++i]);
+        } else if (arg == "--root" && hasValue) {
+            XPHostSetSystemPath(argv[++i]);
+        } else if (arg == "--aircraft" && hasValue) {
+            XPHostLoadUserAircraft(argv[++i]);
+        } else if (arg == "--switch-aircraft" && hasValue) {
+            std::string aircraftSwitch = argv[++i];
+            size_t colon = aircraftSwitch.find(':');
+            if (colon == std::string::npos) {
+                usage();
+                return 1;
+            }
+            aircraftSwitches.push_back(AircraftSwitch{atof(aircraftSwitch.substr(0, colon).c_str()),
+                                                      aircraftSwitch.substr(colon + 1)});
+        } else if (arg == "--realtime") {
+            realtime = true;
+        } else if (arg == "--quiet") {
+            XPHostSetLogEnabled(false);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (fps <= 0.0f) {
+        usage();
+        return 1;
+    }
+
+    applyScript(script, 0.0);
+    if (!XPHostLoadPlugin(pluginPath)) {
+        return 1;
+    }
+
+    for (const std::string& pick : menuPicks) {
+        size_t slash = pick.rfind('/');
+        if (slash == std::string::npos ||
+            !XPHostPickMenuItem(pick.substr(0, slash).c_str(), pick.substr(slash + 1).c_str())) {
+            fprintf(stderr, "No menu item %s\n", pick.c_str());
+        }
+    }
+    for (const std::string& typing : typings) {
+        size_t equals = typing.find('=');
+        if (!XPHostTypeInField(typing.substr(0, equals).c_str(), typing.substr(equals + 1).c_str())) {
+            fprintf(stderr, "No field %s\n", typing.substr(0, equals).c_str());
+        }
+    }
+    for (const std::string& press : presses) {
+        if (!XPHostPressButton(press.c_str())) {
+            fprintf(stderr, "No button %s\n", press.c_str());
+        }
+    }
+
+    std::unique_ptr<FlightProfile> profile;
+    if (useProfile) {
+        profileOptions.fps = fps;
+        profileOptions.seconds = seconds;
+        profile.reset(new FlightProfile(profileOptions));
+    }
+
+    float frameTime = 1.0f / fps;
+    long long frames = static_cast<long long>(seconds * fps);
+    double simTime = 0.0;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    for (long long frame = 1; ; frame++) {
+        float elapsed = frameTime;
+        if (profile) {
+            FlightSample sample;
+            if (!profile->next(sample)) {
+                break;
+            }
+            elapsed = sample.elapsed;
+            XPHostSetDataf(FLIGHT_PROFILE_AOA_DATAREF, sample.aoa);
+            XPHostSetDataf(FLIGHT_PROFILE_IAS_DATAREF, sample.ias);
+            XPHostSetDataf(FLIGHT_PROFILE_G_DATAREF, sample.gLoad);
+            XPHostSetDataf(FLIGHT_PROFILE_FLAP_DATAREF, sample.flapRatio);
+        } else if (frame > frames) {
+            break;
+        }
+        simTime += elapsed;
+
+        applyScript(script, simTime);
+        while (nextSwitch < aircraftSwitches.size() && aircraftSwitches[nextSwitch].time <= simTime) {
+            XPHostLoadUserAircraft(aircraftSwitches[nextSwitch++].path.c_str());
+        }
+        XPHostRunFrame(elapsed);
+
+        if (XPHostTakeReloadRequest()) {
+            XPHostUnloadPlugin();
+            if (!XPHostLoadPlugin(pluginPath)) {
+                return 1;
+            }
+        }
+
+        if (realtime) {
+            std::this_thread::sleep_until(wallStart + std::chrono::duration<double>(simTime));
+        }
+    }
+
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    XPHostStats stats = XPHostGetStats();
+
+    for (const std::string& name : prints) {
+        if (XPHostHasDataRef(name.c_str())) {
+            printf("%s = %g\n", name.c_str(), XPHostGetDataf(name.c_str()));
+        } else {
+            printf("%s missing\n", name.c_str());
+        }
+    }
+
+    XPHostUnloadPlugin();
+
+    printf("frames: %lld  simulated: %.1f s  wall: %.1f ms  per frame: %.2f us\n",
+           stats.frames, simTime, wallMs, stats.frames ? 1000.0 * wallMs / stats.frames : 0.0);
+    printf("flight loop calls: %lld  dataref reads: %lld  widget descriptor sets: %lld\n",
+           stats.flightLoopCalls, stats.dataRefReads, stats.widgetDescriptorSets);
+    printf("window draws: %lld  strings drawn: %lld\n", stats.windowDraws, stats.stringDraws);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "trace.h"
+
+#include <cstdio>
+
+// Which buffer the current thread records into, -1 until it registers
+static thread_local int traceThreadIndex = -1;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TraceRecorder::TraceRecorder()
+    : epoch(std::chrono::steady_clock::now()),
+      threadCount(0),
+      generation(0),
+      running(false),
+      droppedCount(0) {
+    for (int i = 0; i < TRACE_MAX_THREADS; i++) {
+        threads[i].name = "";
+        threads[i].generation.store(0, std::memory_order_relaxed);
+        threads[i].count.store(0, std::memory_order_relaxed);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TraceRecorder::registerThread(const char* threadName) {
+    if (traceThreadIndex >= 0) {
+        threads[traceThreadIndex].name = threadName;
+        return;
+    }
+    int index = threadCount.fetch_add(1);
+    if (index >= TRACE_MAX_THREADS) {
+        threadCount.store(TRACE_MAX_THREADS);
+        return;
+    }
+    threads[index].name = threadName;
+    traceThreadIndex = index;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TraceRecorder::start() {
+    if (running) {
+        return;
+    }
+    for (int i = 0; i < TRACE_MAX_THREADS; i++) {
+        if (!threads[i].events) {
+            threads[i].events.reset(new TraceEvent[TRACE_THREAD_EVENTS]);
+        }
+    }
+
+    // Each thread sees the new generation and restarts its own buffer, nobody else touches its count
+    droppedCount.store(0, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+    running.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop() {
+    running.store(false, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TraceRecorder::record(const char* name, int64_t startNs, int64_t endNs) {
+    if (traceThreadIndex < 0 || !running.load(std::memory_order_acquire)) {
+        return;
+    }
+    ThreadBuffer& buffer = threads[traceThreadIndex];
+
+    unsigned current = generation.load(std::memory_order_acquire);
+    if (buffer.generation.load(std::memory_order_relaxed) != current) {
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.generation.store(current, std::memory_order_release);
+    }
+
+    int count = buffer.count.load(std::memory_order_relaxed);
+    if (count >= TRACE_THREAD_EVENTS) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[count] = TraceEvent{name, startNs, endNs - startNs};
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TraceRecorder::writeJson(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    fprintf(file, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"FlyOnSpeed\"}}");
+
+    unsigned current = generation.load(std::memory_order_acquire);
+    int registered = threadCount.load() < TRACE_MAX_THREADS ? threadCount.load() : TRACE_MAX_THREADS;
+    for (int t = 0; t < registered; t++) {
+        const ThreadBuffer& buffer = threads[t];
+        fprintf(file, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+                t + 1, buffer.name);
+
+        if (!buffer.events || buffer.generation.load(std::memory_order_acquire) != current) {
+            continue;
+        }
+        int count = buffer.count.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) {
+            const TraceEvent& event = buffer.events[i];
+            fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                    event.name, t + 1, event.startNs / 1000.0, event.durationNs / 1000.0);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TraceRecorder& pluginTrace() {
+    static TraceRecorder recorder;
+    return recorder;
+}
@@ -0,0 +1,92 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#define TRACE_MAX_THREADS       8           // Threads that can record
+#define TRACE_THREAD_EVENTS     65536       // Spans each thread can hold, about three minutes of the sim thread
+
+// One finished span
+struct TraceEvent {
+    const char* name;       // string literal, never copied
+    int64_t startNs;        // since the recorder was created
+    int64_t durationNs;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Optional span tracing written out as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+// Each thread that records calls registerThread() once and gets its own buffer, which only it writes, so
+// recording a span is a few stores with no lock. Buffers are allocated by start(), never while recording.
+// When tracing is off a span costs one relaxed atomic load.
+class TraceRecorder {
+public:
+    TraceRecorder();
+
+    // Give the calling thread a buffer. Call once per thread before it records anything.
+    void registerThread(const char* threadName);
+
+    // Begin a new trace, dropping the previous one
+    void start();
+    void stop();
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    void record(const char* name, int64_t startNs, int64_t endNs);
+
+    // Spans dropped because a thread's buffer was full
+    long long dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    // Write everything recorded since start(). Best done after stop().
+    bool writeJson(const char* path) const;
+
+    int64_t nowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+private:
+    struct ThreadBuffer {
+        const char* name;
+        std::unique_ptr<TraceEvent[]> events;
+        std::atomic<unsigned> generation;   // trace the events belong to
+        std::atomic<int> count;
+    };
+
+    std::chrono::steady_clock::time_point epoch;
+    ThreadBuffer threads[TRACE_MAX_THREADS];
+    std::atomic<int> threadCount;
+    std::atomic<unsigned> generation;
+    std::atomic<bool> running;
+    std::atomic<long long> droppedCount;
+};
+
+// The plugin's recorder
+TraceRecorder& pluginTrace();
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Records the enclosing scope as one span if tracing was on when it began
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : spanName(name),
+          startNs(pluginTrace().isRunning() ? pluginTrace().nowNs() : -1) {
+    }
+    ~TraceSpan() {
+        if (startNs >= 0) {
+            pluginTrace().record(spanName, startNs, pluginTrace().nowNs());
+        }
+    }
+
+private:
+    const char* spanName;
+    int64_t startNs;
+};
+
+#define TRACE_CONCAT_INNER(a, b)    a##b
+#define TRACE_CONCAT(a, b)          TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(name)            TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+
+#endif // TRACE_H
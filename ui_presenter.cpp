@@ -0,0 +1,107 @@
+#include "ui_presenter.h"
+
+#include <cstdio>
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+UiPresenter::UiPresenter()
+    : windowWidget(nullptr),
+      aoaValueWidget(nullptr),
+      audioStatusWidget(nullptr),
+      frameCostWidget(nullptr),
+      sinceRefresh(0.0f),
+      metricsShown(nullptr) {
+    invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void UiPresenter::attach(XPWidgetID window, XPWidgetID aoaValue, XPWidgetID audioStatus, XPWidgetID frameCost) {
+    windowWidget = window;
+    aoaValueWidget = aoaValue;
+    audioStatusWidget = audioStatus;
+    frameCostWidget = frameCost;
+    invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void UiPresenter::detach() {
+    windowWidget = nullptr;
+    aoaValueWidget = nullptr;
+    audioStatusWidget = nullptr;
+    frameCostWidget = nullptr;
+    metricsShown = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void UiPresenter::attachMetrics(const MetricsRegistry* metrics, const XPWidgetID* widgets) {
+    metricsShown = metrics;
+    for (int i = 0; metrics && i < metrics->size(); i++) {
+        metricWidgets[i] = widgets[i];
+    }
+    invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void UiPresenter::invalidate() {
+    // Something no caption will ever show, so the next compare always fails
+    strcpy(aoaValueShown, "\x01");
+    strcpy(audioStatusShown, "\x01");
+    strcpy(frameCostShown, "\x01");
+    for (int i = 0; i < METRICS_MAX; i++) {
+        strcpy(metricTextShown[i], "\x01");
+    }
+    sinceRefresh = 1.0e9f;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void UiPresenter::update(float elapsed, const LiveFrame& frame, const AoaThresholds& thresholds, bool tapeVisible) {
+    sinceRefresh += elapsed;
+
+    if (!windowWidget || !XPIsWidgetVisible(windowWidget)) {
+        return;
+    }
+    if (sinceRefresh < 1.0f / UI_REFRESH_RATE) {
+        return;
+    }
+    sinceRefresh = 0.0f;
+
+    char text[64];
+
+    if (tapeVisible) {
+        setText(aoaValueWidget, aoaValueShown, sizeof(aoaValueShown), "AOA: see the AOA tape");
+        setText(audioStatusWidget, audioStatusShown, sizeof(audioStatusShown), "Audio: see the AOA tape");
+    } else {
+        formatAoaText(text, sizeof(text), frame);
+        setText(aoaValueWidget, aoaValueShown, sizeof(aoaValueShown), text);
+
+        formatAudioStatusText(text, sizeof(text), frame, thresholds);
+        setText(audioStatusWidget, audioStatusShown, sizeof(audioStatusShown), text);
+    }
+
+    formatFrameCostText(text, sizeof(text), frame);
+    setText(frameCostWidget, frameCostShown, sizeof(frameCostShown), text);
+
+    // The debug section is collapsed most of the time, skip it entirely then
+    if (metricsShown && metricsShown->size() > 0 && XPIsWidgetVisible(metricWidgets[0])) {
+        for (int i = 0; i < metricsShown->size(); i++) {
+            formatMetricText(text, sizeof(text), *metricsShown, i);
+            setText(metricWidgets[i], metricTextShown[i], sizeof(metricTextShown[i]), text);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void UiPresenter::setText(XPWidgetID widget, char* shown, int shownSize, const char* text) {
+    if (!widget || !strcmp(shown, text)) {
+        return;
+    }
+    snprintf(shown, shownSize, "%s", text);
+    XPSetWidgetDescriptor(widget, shown);
+}
@@ -0,0 +1,54 @@
+#ifndef UI_PRESENTER_H
+#define UI_PRESENTER_H
+
+#include "aoa_engine.h"
+#include "ui_text.h"
+#include "SDK/CHeaders/Widgets/XPWidgets.h"
+
+#define UI_REFRESH_RATE    10.0f   // Live text updates per second in the control window
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pushes the live AOA and audio status text into the control window.
+// Widgets are only touched while the window is visible, at most UI_REFRESH_RATE times a second,
+// and only when the text actually changed. Until attach() is called nothing is touched at all.
+// While the AOA tape is open it shows the AOA and the tone itself, so those two captions just point there and
+// are not updated; they are the fallback for when the tape is closed.
+class UiPresenter {
+public:
+    UiPresenter();
+
+    void attach(XPWidgetID window, XPWidgetID aoaValue, XPWidgetID audioStatus, XPWidgetID frameCost);
+    void detach();
+
+    // Debug section: one caption per metric, updated only while the captions are shown.
+    // widgets must hold metrics->size() entries.
+    void attachMetrics(const MetricsRegistry* metrics, const XPWidgetID* widgets);
+
+    // Forget what has been pushed so the next update() writes every caption, e.g. after the window is shown
+    void invalidate();
+
+    // Call every frame from the flight loop
+    void update(float elapsed, const LiveFrame& frame, const AoaThresholds& thresholds, bool tapeVisible);
+
+private:
+    // Push text to a widget if it differs from what it already shows
+    static void setText(XPWidgetID widget, char* shown, int shownSize, const char* text);
+
+    XPWidgetID windowWidget;
+    XPWidgetID aoaValueWidget;
+    XPWidgetID audioStatusWidget;
+    XPWidgetID frameCostWidget;
+
+    float sinceRefresh;
+
+    char aoaValueShown[64];
+    char audioStatusShown[64];
+    char frameCostShown[64];
+
+    const MetricsRegistry* metricsShown;
+    XPWidgetID metricWidgets[METRICS_MAX];
+    char metricTextShown[METRICS_MAX][48];
+};
+
+#endif // UI_PRESENTER_H
@@ -0,0 +1,70 @@
+#include "ui_text.h"
+
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void formatAoaText(char* text, int size, const LiveFrame& frame) {
+    snprintf(text, size, "AOA: %.1f (avg: %.1f) IAS: %.1f", frame.aoa, frame.avgAoa, frame.ias);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void formatAudioStatusText(char* text, int size, const LiveFrame& frame, const AoaThresholds& thresholds) {
+    if (!frame.audioEnabled) {
+        text[0] = '\0';
+        return;
+    }
+
+    switch (frame.tone.zone) {
+        case ToneZone::BelowIAS:
+            snprintf(text, size, "Audio: None - Below IAS %.1f", thresholds.iasToneEnable);
+            break;
+        case ToneZone::BelowLDMax:
+            snprintf(text, size, "Audio: None - Below L/DMax %.1f", thresholds.belowLDMax);
+            break;
+        case ToneZone::OnSpeed:
+            snprintf(text, size, "Audio: Steady - OnSpeed");
+            break;
+        default:
+            snprintf(text, size, "Audio Hz: %.1f pps: %.1f", frame.tone.frequency, frame.tone.pulseRate);
+            break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void formatTapeToneText(char* text, int size, const LiveFrame& frame) {
+    if (!frame.audioEnabled || frame.tone.frequency <= 0.0f) {
+        snprintf(text, size, "Silent");
+    } else if (frame.tone.pulseRate <= 0.0f) {
+        snprintf(text, size, "Steady %.0f Hz", frame.tone.frequency);
+    } else {
+        snprintf(text, size, "%.1f pps %.0f Hz", frame.tone.pulseRate, frame.tone.frequency);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void formatFrameCostText(char* text, int size, const LiveFrame& frame) {
+    const FrameCostSummary& cost = frame.frameCost;
+    if (cost.frames == 0) {
+        snprintf(text, size, "CPU us: measuring");
+    } else if (cost.overBudget == 0) {
+        snprintf(text, size, "CPU us min %.1f avg %.1f p99 %.1f max %.1f", cost.minUs, cost.meanUs, cost.p99Us,
+                 cost.maxUs);
+    } else {
+        snprintf(text, size, "CPU us min %.1f avg %.1f p99 %.1f max %.1f (%lld over)", cost.minUs, cost.meanUs,
+                 cost.p99Us, cost.maxUs, cost.overBudget);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void formatMetricText(char* text, int size, const MetricsRegistry& metrics, int id) {
+    if (metrics.kind(id) == MetricKind::Counter) {
+        snprintf(text, size, "%s: %d", metrics.label(id), metrics.count(id));
+    } else {
+        snprintf(text, size, "%s: %.1f", metrics.label(id), metrics.gauge(id));
+    }
+}
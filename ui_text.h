@@ -0,0 +1,38 @@
+#ifndef UI_TEXT_H
+#define UI_TEXT_H
+
+#include "aoa_engine.h"
+#include "frame_cost.h"
+#include "metrics.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Text for the live captions in the control window.
+// Kept apart from UiPresenter so it has no widget dependency and the offline tools can run it.
+
+// Everything the live captions show for one frame
+struct LiveFrame {
+    float aoa;              // sample after spike rejection
+    float avgAoa;
+    float ias;
+    bool audioEnabled;
+    ToneState tone;
+    FrameCostSummary frameCost;     // last closed window of flight loop timings
+};
+
+// "AOA: 8.1 (avg: 8.0) IAS: 65.2"
+void formatAoaText(char* text, int size, const LiveFrame& frame);
+
+// What the audio is doing, empty when audio is off
+void formatAudioStatusText(char* text, int size, const LiveFrame& frame, const AoaThresholds& thresholds);
+
+// Tone line of the AOA tape: "4.2 pps 1600 Hz", "Steady 400 Hz" or "Silent"
+void formatTapeToneText(char* text, int size, const LiveFrame& frame);
+
+// "CPU us min 1.1 avg 1.6 p99 3.9 max 7.2", plus how many frames went over budget if any did
+void formatFrameCostText(char* text, int size, const LiveFrame& frame);
+
+// "Spikes rejected: 12" for a counter, "Pulse late ms: 1.4" for a gauge
+void formatMetricText(char* text, int size, const MetricsRegistry& metrics, int id);
+
+#endif // UI_TEXT_H
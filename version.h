@@ -0,0 +1,7 @@
+#ifndef VERSION_H
+#define VERSION_H
+
+#define FLYONSPEED_VERSION  "0.1.12"
+#define FLYONSPEED_DATE     "4/23/2025"
+
+#endif // VERSION_H
@@ -0,0 +1,69 @@
+#include "warm_state.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void initWarmState(WarmState& state) {
+    memset(&state, 0, sizeof(state));
+    memcpy(state.magic, WARM_STATE_MAGIC, sizeof(state.magic));
+    state.version = WARM_STATE_VERSION;
+    state.size = sizeof(WarmState);
+    state.savedUnixTime = static_cast<int64_t>(time(nullptr));
+}
+
+int64_t warmStateAge(const WarmState& state) {
+    return static_cast<int64_t>(time(nullptr)) - state.savedUnixTime;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool writeWarmState(const char* path, const WarmState& state) {
+    char temporary[1024];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+    FILE* file = fopen(temporary, "wb");
+    if (!file) {
+        return false;
+    }
+    bool written = fwrite(&state, sizeof(state), 1, file) == 1;
+    if (fclose(file) != 0 || !written) {
+        remove(temporary);
+        return false;
+    }
+
+#ifdef _WIN32
+    remove(path);       // rename won't replace a file on Windows
+#endif
+    if (rename(temporary, path) != 0) {
+        remove(temporary);
+        return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool readWarmState(const char* path, WarmState& state, char* error, int errorSize) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        snprintf(error, errorSize, "no snapshot");
+        return false;
+    }
+    size_t read = fread(&state, 1, sizeof(state), file);
+    fclose(file);
+    remove(path);
+
+    if (read != sizeof(state) || memcmp(state.magic, WARM_STATE_MAGIC, sizeof(state.magic)) != 0) {
+        snprintf(error, errorSize, "not a snapshot");
+        return false;
+    }
+    if (state.version != WARM_STATE_VERSION || state.size != sizeof(WarmState)) {
+        snprintf(error, errorSize, "snapshot from another build");
+        return false;
+    }
+    state.aircraft[AIRCRAFT_NAME_MAX - 1] = '\0';
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef WARM_STATE_H
+#define WARM_STATE_H
+
+#include "aircraft_profile.h"
+#include "aoa_engine.h"
+
+#include <cstdint>
+
+#define WARM_STATE_MAGIC            "FOSWARM"   // 8 bytes with the terminator
+#define WARM_STATE_VERSION          1
+#define WARM_STATE_MAX_AGE_SECONDS  30          // Older snapshots are ignored, the aircraft has moved on
+
+// The plugin's running state, written when it is disabled and read back when it is enabled again, so a
+// plugin reload doesn't restart the filter from a 0° history. Binary and host endian: it is only ever read
+// back by the same build on the same machine, and the version and size fields reject anything else.
+struct WarmState {
+    char magic[8];                      // WARM_STATE_MAGIC
+    uint32_t version;                   // WARM_STATE_VERSION
+    uint32_t size;                      // sizeof(WarmState)
+    int64_t savedUnixTime;              // wall clock seconds when written
+    char aircraft[AIRCRAFT_NAME_MAX];   // acf file name of the user aircraft
+
+    // Filter and zone
+    AoaFilterState filter;
+    int32_t zone;                       // ToneZone
+
+    // Config
+    AoaThresholds thresholds;
+    ToneSettings tone;
+    int32_t aoaSourceIndex;             // AOA_SOURCES
+    int32_t audioEnabled;
+};
+
+// Fill in the header fields, stamped with the current time
+void initWarmState(WarmState& state);
+
+// Written to a temporary file and renamed over path, so a crash can't leave half a snapshot
+bool writeWarmState(const char* path, const WarmState& state);
+
+// Reads and checks the header, then deletes the file so a snapshot is only ever restored once. Returns false
+// with a reason in error if there is no usable snapshot. Freshness is up to the caller.
+bool readWarmState(const char* path, WarmState& state, char* error, int errorSize);
+
+// Seconds since the snapshot was written
+int64_t warmStateAge(const WarmState& state);
+
+#endif // WARM_STATE_H